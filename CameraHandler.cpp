@@ -1,618 +1,342 @@
-#include "opencv2/opencv.hpp"
 #include "CameraHandler.h"
 #include "ui_CameraHandler.h"
+#include "vision/visionWorker.h"
+#include <QDateTime>
+#include <QDir>
 #include <QString>
-#include <QImage>
-#include <iostream>
-#include <QFile>
-#include <QTemporaryFile>
-
-using namespace cv;
-using namespace std;
+#include <QStandardPaths>
+#include <QPixmap>
 
 CameraHandler::CameraHandler(QWidget *parent) : QWidget(parent),
-                                                ui(new Ui::CameraHandler)
+                                                ui(new Ui::CameraHandler),
+                                                m_framesSinceLatencyUpdate(0)
 {
     ui->setupUi(this);
 
+    // Capture and detection run on the vision thread, results come back through a queued signal
+    m_worker = new VisionWorker();
+    connect(m_worker, &VisionWorker::frameProcessed, this, &CameraHandler::onFrameProcessed);
+    connect(m_worker, &VisionWorker::sourceFinished, this, [this]()
+            { ui->detectionLabel_->setText("End of replay"); });
+    m_worker->setSettings(m_settings);
+
+    // Detector backend selection, in VisionSettings::DetectorBackend order
+    ui->detectorComboBox_->addItems(QStringList() << "Haar cascades" << "Skin colour");
+    ui->detectorComboBox_->setCurrentIndex(m_settings.detectorBackend);
+    connect(ui->detectorComboBox_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index)
+            { setDetectorBackend(static_cast<VisionSettings::DetectorBackend>(index)); });
+
+    // Two-sword mode
+    ui->twoHandsCheckBox_->setChecked(isTwoHandsEnabled());
+    connect(ui->twoHandsCheckBox_, &QCheckBox::toggled, this, &CameraHandler::setTwoHandsEnabled);
+
+    // Session recording for offline analysis
+    connect(ui->recordCheckBox_, &QCheckBox::toggled, this, [this](bool checked)
+            {
+        if (checked)
+        {
+            startRecording();
+        }
+        else
+        {
+            stopRecording();
+        } });
+
+    // Optional per-stage latency overlay
+    ui->latencyLabel_->hide();
+    connect(ui->latencyCheckBox_, &QCheckBox::toggled, ui->latencyLabel_, &QLabel::setVisible);
+
+    // Tracker backend selection
+    ui->trackerComboBox_->addItems(HandTracker::backendNames());
+    ui->trackerComboBox_->setCurrentIndex(m_settings.trackerBackend);
+    connect(ui->trackerComboBox_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index)
+            { setTrackerBackend(static_cast<HandTracker::Backend>(index)); });
+
     // Initialize with internal camera (index 0)
-    webCam_ = new VideoCapture(0);
-    hasReference = false;
-    hasDetection = false;
-    consecutiveDetections = 0;
-    matchQuality = 0;
-    detectionTimer.start();
-    debug = false; // Set debug to false by default
-
-    // Initialize hand position to middle of the camera frame
-    int width = webCam_->get(CAP_PROP_FRAME_WIDTH);
-    int height = webCam_->get(CAP_PROP_FRAME_HEIGHT);
-
-    // Initialize to middle of frame or reasonable fallback values
-    m_handPosition[0] = width > 0 ? width / 2 : 320;
-    m_handPosition[1] = height > 0 ? height / 2 : 240;
-
-    if (!webCam_->isOpened())
+    if (!openCamera(0))
     {
         ui->detectionLabel_->setText("Error opening the default camera!");
         ui->imageLabel_->setText("No image");
     }
-    else
-    {
-        ui->detectionLabel_->setText(QString("Video ok, image size is %1x%2 pixels").arg(width).arg(height));
-        timer = new QTimer(this);
-        connect(timer, SIGNAL(timeout()), this, SLOT(updateFrame()));
-        timer->start(30);
-    }
 }
 
 CameraHandler::~CameraHandler()
 {
-    timer->stop();
-    delete timer;
+    // Stop the vision thread before the objects it uses are destroyed
+    m_worker->stop();
+    delete m_worker;
     delete ui;
-    delete webCam_;
 }
 
-Rect CameraHandler::haarCascade(Mat &image)
+HandSample CameraHandler::latestHandSample(int hand) const
 {
-    CascadeClassifier fist_cascade;
-    CascadeClassifier palm_cascade;
-
-    // Utilisation de QFile pour charger les fichiers XML depuis les ressources
-    QStringList resourceFiles = {":/hand.xml", ":/Hand.Cascade.1.xml"};
-    QStringList tempFiles;
-    for (const QString &res : resourceFiles) {
-        QFile file(res);
-        if (!file.open(QIODevice::ReadOnly)) {
-            cerr << "Erreur lors de l'ouverture de la ressource " << res.toStdString() << endl;
-            return Rect();
-        }
-        QTemporaryFile *tmp = new QTemporaryFile();
-        if (!tmp->open()) {
-            cerr << "Erreur lors de la création du fichier temporaire pour " << res.toStdString() << endl;
-            return Rect();
-        }
-        tmp->write(file.readAll());
-        tmp->flush();
-        tempFiles << tmp->fileName();
-        // On ne ferme pas tmp ici pour garder le fichier accessible
+    if (hand < 0 || hand >= VisionSettings::MAX_HANDS)
+    {
+        return HandSample();
     }
 
-    // Charger les cascadeurs Haar avec les fichiers temporaires
-    if (!fist_cascade.load(tempFiles[0].toStdString()))
+    HandSample &sample = m_latestSamples[hand];
+    m_worker->readLatestSample(sample, hand);
+
+    // The history ignores a sample it already holds
+    if (sample.valid && sample.confidence >= MIN_HISTORY_CONFIDENCE)
     {
-        cerr << "Error loading hand.xml depuis la ressource" << endl;
-        return Rect();
+        m_handHistories[hand].add(sample.timestampNs, toNormalizedPosition(sample), sample.confidence, sample.sequence);
     }
-    if (!palm_cascade.load(tempFiles[1].toStdString()))
+    return sample;
+}
+
+bool CameraHandler::handPositionAt(qint64 timeNs, QVector3D &position, int hand) const
+{
+    if (hand < 0 || hand >= VisionSettings::MAX_HANDS)
     {
-        cerr << "Error loading Hand.Cascade.1.xml depuis la ressource" << endl;
-        return Rect();
+        return false;
     }
+    return m_handHistories[hand].positionAt(timeNs, position);
+}
 
-    Mat frame_gray;
-    std::vector<Rect> fists;
-    std::vector<Rect> invfists;
-    std::vector<Rect> palms;
-    std::vector<Rect> invPalms;
-
-    cv::cvtColor(image, frame_gray, COLOR_BGR2GRAY);
-    cv::equalizeHist(frame_gray, frame_gray); // Improve contrast for better detection
-
-    // First try to detect fists
-    fist_cascade.detectMultiScale(frame_gray, fists, 1.1, 13, 1, Size(80, 80), Size(160, 160));
+VisionStats CameraHandler::visionStats() const
+{
+    m_worker->readLatestStats(m_latestStats);
+    return m_latestStats;
+}
 
-    Mat invFrame_gray = 255 - frame_gray; // Invert image for better palm detection
-    palm_cascade.detectMultiScale(invFrame_gray, invfists, 1.1, 13, 1, Size(80, 80), Size(160, 160));
-    fists.insert(fists.end(), invfists.begin(), invfists.end());
+LatencySummary CameraHandler::stageLatency(VisionProfiler::Stage stage) const
+{
+    return visionStats().stageLatency[stage];
+}
 
-    // Second attempt: detect palms if no fists found
-    if (fists.size() <= 0)
+QString CameraHandler::latencyReport() const
+{
+    VisionStats stats = visionStats();
+    QString report = QString("%1 %2 %3 %4").arg("stage (ms)", -18).arg("p50", 6).arg("p95", 6).arg("p99", 6);
+    for (int stage = 0; stage < VisionProfiler::StageCount; stage++)
     {
-        palm_cascade.detectMultiScale(frame_gray, palms, 1.1, 13, 1, Size(80, 80), Size(160, 160));
-        // try inverted image for palm detection
-        palm_cascade.detectMultiScale(invFrame_gray, invPalms, 1.1, 13, 1, Size(80, 80), Size(160, 160));
-        palms.insert(palms.end(), invPalms.begin(), invPalms.end());
-    }
-
-    Rect detectedRect;
+        const LatencySummary &latency = stats.stageLatency[stage];
+        if (latency.count == 0)
+        {
+            continue;
+        }
 
-    // Prioritize fist detection over palm detection
-    if (fists.size() > 0)
-    {
-        detectedRect = fists[0];
-    }
-    else if (palms.size() > 0)
-    {
-        detectedRect = palms[0];
+        report += QString("\n%1 %2 %3 %4")
+                      .arg(VisionProfiler::stageName(static_cast<VisionProfiler::Stage>(stage)), -18)
+                      .arg(latency.p50, 6, 'f', 1)
+                      .arg(latency.p95, 6, 'f', 1)
+                      .arg(latency.p99, 6, 'f', 1);
     }
+    return report;
+}
 
-    // Draw detection rectangle only during initial detection phase
-    if (!hasReference && !detectedRect.empty())
-    {
-        rectangle(image, detectedRect, Scalar(0, 255, 0), 2);
-    }
+const cv::Mat *CameraHandler::acquireLatestFrame()
+{
+    return m_worker->acquireLatestFrame();
+}
 
-    return detectedRect;
+void CameraHandler::setFramePreviewEnabled(bool enabled)
+{
+    m_worker->setFramePreviewEnabled(enabled);
 }
 
-void CameraHandler::captureReference()
+void CameraHandler::setImagePreviewEnabled(bool enabled)
 {
-    if (webCam_->isOpened() && hasDetection)
+    m_worker->setImagePreviewEnabled(enabled);
+    ui->imageLabel_->setVisible(enabled);
+}
+
+QVector3D CameraHandler::toNormalizedPosition(const HandSample &sample)
+{
+    if (sample.frameWidth <= 0 || sample.frameHeight <= 0)
     {
-        Mat frame;
-        if (webCam_->read(frame))
-        {
-            flip(frame, frame, 1); // Mirror image for natural interaction
+        return QVector3D(0.0f, 0.0f, 0.0f);
+    }
 
-            // Get frame dimensions for boundary checking
-            int frameWidth = frame.cols;
-            int frameHeight = frame.rows;
+    // Use the tracked hand position
+    float handX_px = sample.x;
+    float handY_px = sample.y;
 
-            // Safety check - ensure the detection rectangle is within the frame boundaries
-            Rect safeRect = lastDetectedRect;
-            safeRect.x = std::max(0, std::min(frameWidth - 1, safeRect.x));
-            safeRect.y = std::max(0, std::min(frameHeight - 1, safeRect.y));
-            safeRect.width = std::min(frameWidth - safeRect.x, safeRect.width);
-            safeRect.height = std::min(frameHeight - safeRect.y, safeRect.height);
+    // Normalize to -1 to 1 range
+    // X: -1 (left) to 1 (right)
+    // Y: -1 (bottom) to 1 (top)
+    float normalizedX = 2.0f * (handX_px / sample.frameWidth) - 1.0f;
+    float normalizedY = 1.0f - 2.0f * (handY_px / sample.frameHeight); // Invert Y axis
 
-            // Skip if rectangle is too small after safety adjustments
-            if (safeRect.width < 10 || safeRect.height < 10)
-            {
-                std::cout << "Warning: Adjusted rectangle too small for reference image" << std::endl;
-                return;
-            }
-
-            // Adjust detection rectangle to better focus on the hand
-            Rect adjustedRect = safeRect;
-            adjustedRect.y = std::min(frameHeight - 1, adjustedRect.y + static_cast<int>(adjustedRect.height * 0.2));
-
-            // Ensure adjusted height doesn't go beyond frame boundary
-            adjustedRect.height = std::min(frameHeight - adjustedRect.y, adjustedRect.height);
-
-            // Calculate crop dimensions to focus on central part of hand
-            int cropX = static_cast<int>(adjustedRect.width * 0.3);
-            int cropY = static_cast<int>(-adjustedRect.height * 0.2);
-
-            // Ensure cropY doesn't move the rectangle outside the frame
-            cropY = std::max(-adjustedRect.y, cropY);
-
-            // Define final rectangle for reference image with boundary checks
-            Rect finalRect(
-                std::max(0, adjustedRect.x + cropX),
-                std::max(0, adjustedRect.y + cropY),
-                std::min(frameWidth - (adjustedRect.x + cropX), adjustedRect.width - 2 * cropX),
-                std::min(frameHeight - (adjustedRect.y + cropY), adjustedRect.height - 2 * cropY));
-
-            // Ensure the final rectangle is not empty or too small
-            if (finalRect.width <= 0 || finalRect.height <= 0 ||
-                finalRect.width < 10 || finalRect.height < 10)
-            {
-                std::cout << "Warning: Invalid reference rectangle dimensions" << std::endl;
-                return;
-            }
+    // Create QVector3D with Z=0 (2D tracking)
+    return QVector3D(normalizedX, normalizedY, 0.0f);
+}
 
-            try
-            {
-                // Extract region of interest and store as reference
-                Mat roi = frame(finalRect);
-                reference = roi.clone();
-                hasReference = true;
-                updateStatusText();
-
-                // Display reference image when in debug mode
-                if (debug)
-                {
-                    namedWindow("Reference Image", WINDOW_NORMAL);
-                    imshow("Reference Image", reference);
-                    resizeWindow("Reference Image", reference.cols, reference.rows);
-                    waitKey(1); // Refresh the window
-                }
-            }
-            catch (const cv::Exception &e)
-            {
-                std::cerr << "OpenCV error in captureReference: " << e.what() << std::endl;
-                hasReference = false;
-            }
-        }
-    }
+QVector3D CameraHandler::getHandPosition() const
+{
+    return toNormalizedPosition(latestHandSample());
 }
 
-void CameraHandler::updateStatusText()
+QPoint CameraHandler::getTrackedHandPosition() const
 {
-    if (!hasDetection)
+    HandSample sample = latestHandSample();
+    return QPoint(sample.x, sample.y);
+}
+
+void CameraHandler::onFrameProcessed(const QImage &preview, const QString &status)
+{
+    // Ignore frames still queued when the camera was released
+    if (!m_worker->isRunning())
+    {
+        return;
+    }
+
+    // The preview image is null when the frames are displayed by the game view
+    if (!preview.isNull())
     {
-        ui->detectionLabel_->setText("...");
+        ui->imageLabel_->setPixmap(QPixmap::fromImage(preview));
+        ui->imageLabel_->setAlignment(Qt::AlignCenter);
     }
-    else if (!hasReference)
+    ui->detectionLabel_->setText(status);
+
+    // Search window statistics, shown on hover to help tuning the window
+    VisionStats stats = visionStats();
+    ui->detectionLabel_->setToolTip(QString("Search window: %1% of searches, %2% hits, level %3\n"
+                                            "Full frame: %4 searches, %5 hits\n"
+                                            "Detection on %6% of the frames, every %7 tracked frames\n"
+                                            "Camera: %8 frames processed, %9 dropped, %10 late")
+                                        .arg(qRound(stats.windowRatio() * 100))
+                                        .arg(qRound(stats.windowHitRate() * 100))
+                                        .arg(stats.searchWindowLevel)
+                                        .arg(stats.fullFrameSearches)
+                                        .arg(stats.fullFrameHits)
+                                        .arg(qRound(stats.detectionRatio() * 100))
+                                        .arg(stats.redetectInterval)
+                                        .arg(stats.processedFrames)
+                                        .arg(stats.droppedFrames)
+                                        .arg(stats.lateFrames));
+
+    // Frames written and dropped by the recorder
+    if (isRecording())
     {
-        ui->detectionLabel_->setText(QString("%1/%2").arg(consecutiveDetections).arg(REQUIRED_DETECTIONS));
+        SessionRecorder &recorder = m_worker->recorder();
+        ui->recordCheckBox_->setText(QString("Record session (%1 frames, %2 dropped)")
+                                         .arg(recorder.framesWritten())
+                                         .arg(recorder.framesDropped()));
     }
-    else
+
+    // Refresh the latency overlay a few times per second only
+    if (ui->latencyLabel_->isVisible() && ++m_framesSinceLatencyUpdate >= LATENCY_REFRESH_FRAMES)
     {
-        ui->detectionLabel_->setText(QString("%1% sift").arg(matchQuality));
+        m_framesSinceLatencyUpdate = 0;
+        ui->latencyLabel_->setText(latencyReport());
     }
+
+    // Let the worker scale the next preview to the current label size
+    m_worker->setPreviewSize(ui->imageLabel_->size());
 }
 
-bool CameraHandler::isDetectionClose(const Rect &current, const Rect &previous)
+void CameraHandler::setVisionSettings(const VisionSettings &settings)
 {
-    // Calculate the centers of both rectangles
-    Point currentCenter(current.x + current.width / 2, current.y + current.height / 2);
-    Point previousCenter(previous.x + previous.width / 2, previous.y + previous.height / 2);
-
-    // Calculate the Euclidean distance between centers
-    double distance = sqrt(pow(currentCenter.x - previousCenter.x, 2) +
-                           pow(currentCenter.y - previousCenter.y, 2));
+    m_settings = settings;
+    m_worker->setSettings(m_settings);
+}
 
-    // Calculate the average size of the rectangles
-    double avgSize = (current.width + current.height + previous.width + previous.height) / 4.0;
+void CameraHandler::setDetectorBackend(VisionSettings::DetectorBackend backend)
+{
+    if (backend < 0 || backend >= VisionSettings::DetectorBackendCount)
+    {
+        return;
+    }
 
-    // Consider it close if the distance is less than 30% of the average size
-    return distance < (0.3 * avgSize);
+    VisionSettings settings = m_settings;
+    settings.detectorBackend = backend;
+    setVisionSettings(settings);
 }
 
-void CameraHandler::updateFrame()
+void CameraHandler::setTrackerBackend(HandTracker::Backend backend)
 {
-    if (webCam_->isOpened())
+    if (backend < 0 || backend >= HandTracker::BackendCount)
     {
-        Mat frame;
-        if (webCam_->read(frame))
-        {
-            flip(frame, frame, 1); // Mirror image for natural interaction
-            Mat frameToDisplay = frame.clone();
-
-            // Phase 1: Hand detection and reference image capture
-            if (!hasReference)
-            {
-                Rect detected = haarCascade(frameToDisplay);
-                if (detected.width > 0 && detected.height > 0)
-                {
-                    bool isClose = false;
-                    if (hasDetection)
-                    {
-                        isClose = isDetectionClose(detected, lastDetectedRect);
-                    }
-
-                    // Check if the new detection is close to the previous one or if this is the first detection
-                    if (isClose || !hasDetection)
-                    {
-                        // Check if we haven't timed out (5 seconds since last detection)
-                        if (detectionTimer.elapsed() < 5000 || !hasDetection)
-                        {
-                            consecutiveDetections++;
-                        }
-                        else
-                        {
-                            // It's been too long since the last detection, reset counter
-                            consecutiveDetections = 1;
-                        }
-                    }
-                    else
-                    {
-                        // Detection is not close to the previous one, reset counter
-                        consecutiveDetections = 1;
-                    }
-
-                    lastDetectedRect = detected;
-                    hasDetection = true;
-                    detectionTimer.restart();
-
-                    // Log detection progress
-                    std::cout << consecutiveDetections << "/" << REQUIRED_DETECTIONS << std::endl;
-
-                    // Capture reference once we have enough consistent detections
-                    if (consecutiveDetections >= REQUIRED_DETECTIONS)
-                    {
-                        captureReference();
-                        std::cout << "Reference captured!" << std::endl;
-                    }
-                }
-                else
-                {
-                    // Reset if no detection for too long
-                    if (detectionTimer.elapsed() > 5000 && consecutiveDetections > 0)
-                    {
-                        std::cout << "No detection for too long, resetting counter" << std::endl;
-                        consecutiveDetections = 0;
-                        hasDetection = false;
-                    }
-                }
-
-                updateStatusText();
-            }
-            // Phase 2: Feature matching and tracking
-            else
-            {
-                // Store original frame before adding annotations
-                Mat originalFrame = frameToDisplay.clone();
-
-                Rect detected = haarCascade(originalFrame);
-                frameToDisplay = originalFrame.clone();
-
-                if (detected.width > 0 && detected.height > 0)
-                {
-                    lastDetectedRect = detected;
-
-                    // Ensure the detected rectangle is within frame boundaries
-                    int frameWidth = frameToDisplay.cols;
-                    int frameHeight = frameToDisplay.rows;
-
-                    Rect safeRect = lastDetectedRect;
-                    safeRect.x = std::max(0, std::min(frameWidth - 1, safeRect.x));
-                    safeRect.y = std::max(0, std::min(frameHeight - 1, safeRect.y));
-                    safeRect.width = std::min(frameWidth - safeRect.x, safeRect.width);
-                    safeRect.height = std::min(frameHeight - safeRect.y, safeRect.height);
-
-                    // Skip processing if the rectangle is too small after adjustments
-                    if (safeRect.width < 10 || safeRect.height < 10)
-                    {
-                        std::cout << "Warning: Adjusted rectangle too small for feature matching" << std::endl;
-                        return;
-                    }
-
-                    // Use safe rectangle instead of potentially unsafe lastDetectedRect
-                    try
-                    {
-                        Mat currentFrame = frameToDisplay(safeRect).clone();
-
-                        // Apply SIFT matching with reference image
-                        std::vector<KeyPoint> keypoints = applySIFT(reference, currentFrame);
-
-                        // Draw detection rectangle
-                        rectangle(frameToDisplay, safeRect, Scalar(0, 255, 0), 1);
-
-                        // Fallback to center point if SIFT matching quality is poor
-                        if (matchQuality < 5)
-                        {
-                            static int lowQualityCounter = 0;
-                            lowQualityCounter++;
-
-                            // Draw the middle point of the detection as fallback
-                            Point centerPoint(safeRect.x + safeRect.width / 2,
-                                              safeRect.y + safeRect.height / 2);
-
-                            // Update the tracked hand position
-                            setTrackedHandPosition(centerPoint.x, centerPoint.y);
-
-                            // Draw a red circle at the tracking point for visibility
-                            circle(frameToDisplay, centerPoint, 5, Scalar(0, 0, 255), -1);
-
-                            std::cout << "Low match quality, using detection center. Counter: "
-                                      << lowQualityCounter << "/10" << std::endl;
-
-                            // Reset reference if consistently poor matches
-                            if (lowQualityCounter > 10)
-                            {
-                                std::cout << "Consistently poor matches, capturing new reference..." << std::endl;
-                                hasReference = false;
-                                consecutiveDetections = 0;
-                                lowQualityCounter = 0;
-                            }
-                        }
-                        else
-                        {
-                            // Good SIFT match - reset counter and draw keypoints
-                            static int lowQualityCounter = 0;
-                            lowQualityCounter = 0;
-
-                            // Calculate average position of keypoints for better tracking
-                            Point avgPoint(0, 0);
-                            if (keypoints.size() > 0)
-                            {
-                                for (const KeyPoint &kp : keypoints)
-                                {
-                                    avgPoint.x += safeRect.x + kp.pt.x;
-                                    avgPoint.y += safeRect.y + kp.pt.y;
-                                }
-                                avgPoint.x /= keypoints.size();
-                                avgPoint.y /= keypoints.size();
-
-                                // Update the tracked hand position
-                                setTrackedHandPosition(avgPoint.x, avgPoint.y);
-
-                                // Draw a red circle at the tracking point
-                                circle(frameToDisplay, avgPoint, 5, Scalar(0, 0, 255), -1);
-                            }
-                            else
-                            {
-                                // Fallback to center of detection rectangle if no keypoints
-                                Point centerPoint(safeRect.x + safeRect.width / 2,
-                                                  safeRect.y + safeRect.height / 2);
-                                setTrackedHandPosition(centerPoint.x, centerPoint.y);
-                                circle(frameToDisplay, centerPoint, 5, Scalar(0, 0, 255), -1);
-                            }
-
-                            // Visualize keypoints
-                            for (const KeyPoint &kp : keypoints)
-                            {
-                                // Adjust keypoint position to be relative to the detected rectangle
-                                Point pt(safeRect.x + kp.pt.x, safeRect.y + kp.pt.y);
-                                // Check if the point is within the frame boundaries
-                                if (pt.x >= 0 && pt.x < frameWidth && pt.y >= 0 && pt.y < frameHeight)
-                                {
-                                    circle(frameToDisplay, pt, 2, Scalar(0, 255, 0), -1);
-                                }
-                            }
-                        }
-                    }
-                    catch (const cv::Exception &e)
-                    {
-                        std::cerr << "OpenCV error in updateFrame: " << e.what() << std::endl;
-                    }
-
-                    std::cout << "Match: " << matchQuality << "%" << std::endl;
-                }
-                else
-                {
-                    // Reset match quality when no detection
-                    if (matchQuality > 0)
-                    {
-                        std::cout << "Match: 0%" << std::endl;
-                        matchQuality = 0;
-                        updateStatusText();
-                    }
-
-                    // Reset reference if consistently can't detect anything
-                    static int noDetectionCounter = 0;
-                    noDetectionCounter++;
-
-                    if (noDetectionCounter > 60)
-                    {
-                        std::cout << "No detection for too long, resetting reference..." << std::endl;
-                        hasReference = false;
-                        consecutiveDetections = 0;
-                        noDetectionCounter = 0;
-                    }
-                }
-            }
-
-            Mat displayFrame;
-            cvtColor(frameToDisplay, displayFrame, COLOR_BGR2RGB);
-            QImage img = QImage((const unsigned char *)(displayFrame.data),
-                                displayFrame.cols, displayFrame.rows,
-                                QImage::Format_RGB888);
-
-            // Scale image while preserving aspect ratio
-            ui->imageLabel_->setPixmap(QPixmap::fromImage(img).scaled(
-                ui->imageLabel_->width(),
-                ui->imageLabel_->height(),
-                Qt::KeepAspectRatio,
-                Qt::SmoothTransformation));
-
-            ui->imageLabel_->setAlignment(Qt::AlignCenter);
-        }
+        return;
     }
+
+    VisionSettings settings = m_settings;
+    settings.trackerBackend = backend;
+    setVisionSettings(settings);
 }
 
-Mat CameraHandler::rotateImage(const Mat &src, float angle)
+void CameraHandler::setTwoHandsEnabled(bool enabled)
 {
-    // Calculate image center
-    Point2f center(src.cols / 2.0f, src.rows / 2.0f);
-
-    // Create rotation matrix
-    Mat rotMatrix = getRotationMatrix2D(center, angle, 1.0);
+    if (enabled == isTwoHandsEnabled())
+    {
+        return;
+    }
 
-    // Apply rotation
-    Mat result;
-    warpAffine(src, result, rotMatrix, src.size());
+    VisionSettings settings = m_settings;
+    settings.maxHands = enabled ? VisionSettings::MAX_HANDS : 1;
+    setVisionSettings(settings);
 
-    return result;
+    // A second hand seen before the mode was disabled must not be interpolated from later on
+    m_handHistories[1].clear();
+    ui->twoHandsCheckBox_->setChecked(enabled);
+    emit twoHandsChanged(enabled);
 }
 
-std::vector<KeyPoint> CameraHandler::applySIFT(Mat &image1, Mat &image2)
+bool CameraHandler::startRecording(const QString &directory)
 {
-    // Check if input images are valid
-    if (image1.empty() || image2.empty())
+    if (isRecording())
     {
-        std::cerr << "Empty images provided to SIFT matcher" << std::endl;
-        matchQuality = 0;
-        updateStatusText();
-        return std::vector<KeyPoint>();
+        return true;
     }
 
-    try
+    QSize size = m_worker->frameSize();
+    QString path = directory;
+    if (path.isEmpty())
     {
-        Mat img1 = image1;
-        Mat img2 = image2;
-        Ptr<SIFT> detector = SIFT::create();
-        std::vector<KeyPoint> keypoints1, keypoints2;
-        Mat descriptors1, descriptors2;
-        detector->detectAndCompute(img1, noArray(), keypoints1, descriptors1);
-        detector->detectAndCompute(img2, noArray(), keypoints2, descriptors2);
-
-        // Check if descriptors are empty or not enough keypoints
-        if (descriptors1.empty() || descriptors2.empty() || keypoints1.size() < 4 || keypoints2.size() < 4)
-        {
-            matchQuality = 0;
-            updateStatusText();
-            return keypoints2;
-        }
-
-        Ptr<DescriptorMatcher> matcher = DescriptorMatcher::create(DescriptorMatcher::FLANNBASED);
-        std::vector<std::vector<DMatch>> knn_matches;
-
-        // Check if we have enough matches to do knnMatch with k=2
-        if (descriptors1.rows < 2 || descriptors2.rows < 2)
-        {
-            // Not enough descriptors for knnMatch with k=2
-            // Fall back to simple match
-            std::vector<DMatch> simple_matches;
-            matcher->match(descriptors1, descriptors2, simple_matches);
-            matchQuality = min(100, static_cast<int>(simple_matches.size() * 100.0 / max(1, static_cast<int>(keypoints1.size()))));
-            updateStatusText();
-            return keypoints2;
-        }
-
-        matcher->knnMatch(descriptors1, descriptors2, knn_matches, 2);
-
-        // Apply ratio test to find good matches
-        std::vector<DMatch> good_matches;
-        for (size_t i = 0; i < knn_matches.size(); i++)
-        {
-            if (knn_matches[i].size() > 1)
-            {
-                if (knn_matches[i][0].distance < m_siftRationTresh * knn_matches[i][1].distance)
-                {
-                    good_matches.push_back(knn_matches[i][0]);
-                }
-            }
-        }
-
-        // Calculate match quality as a percentage (0-100)
-        matchQuality = min(100, static_cast<int>(good_matches.size() * 100.0 / max(1, static_cast<int>(keypoints1.size()))));
-
-        updateStatusText();
-        return keypoints2;
+        QString recordings = QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("recordings");
+        path = QDir(recordings).filePath(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
     }
-    catch (const cv::Exception &e)
+
+    QString error = "No video to record";
+    if (size.isEmpty() ||
+        !m_worker->recorder().start(path, cv::Size(size.width(), size.height()), m_worker->frameRate(), error))
     {
-        std::cerr << "OpenCV error in applySIFT: " << e.what() << std::endl;
-        matchQuality = 0;
-        updateStatusText();
-        return std::vector<KeyPoint>();
+        ui->detectionLabel_->setText(error);
+        ui->recordCheckBox_->setChecked(false);
+        return false;
     }
+
+    ui->recordCheckBox_->setChecked(true);
+    ui->recordCheckBox_->setToolTip(QString("Recording to %1").arg(QDir::toNativeSeparators(path)));
+    emit recordingChanged(true);
+    return true;
 }
 
-QVector3D CameraHandler::getHandPosition() const
+void CameraHandler::stopRecording()
 {
-    // Get frame dimensions
-    int frameWidth = webCam_->get(cv::CAP_PROP_FRAME_WIDTH);
-    int frameHeight = webCam_->get(cv::CAP_PROP_FRAME_HEIGHT);
-
-    // Use the tracked hand position
-    float handX_px = m_handPosition[0];
-    float handY_px = m_handPosition[1];
-
-    // Normalize to -1 to 1 range
-    // X: -1 (left) to 1 (right)
-    // Y: -1 (bottom) to 1 (top)
-    float normalizedX = 2.0f * (handX_px / frameWidth) - 1.0f;
-    float normalizedY = 1.0f - 2.0f * (handY_px / frameHeight); // Invert Y axis
+    if (!isRecording())
+    {
+        return;
+    }
 
-    // Create QVector3D with Z=0 (2D tracking)
-    return QVector3D(normalizedX, normalizedY, 0.0f);
+    SessionRecorder &recorder = m_worker->recorder();
+    recorder.stop();
+    ui->recordCheckBox_->setChecked(false);
+    ui->recordCheckBox_->setText("Record session");
+    ui->recordCheckBox_->setToolTip(QString("Last session: %1 frames written, %2 dropped, in %3")
+                                        .arg(recorder.framesWritten())
+                                        .arg(recorder.framesDropped())
+                                        .arg(QDir::toNativeSeparators(recorder.directory())));
+    emit recordingChanged(false);
 }
 
-void CameraHandler::setTrackedHandPosition(int x, int y)
+bool CameraHandler::isRecording() const
 {
-    m_handPosition[0] = x;
-    m_handPosition[1] = y;
+    return m_worker->recorder().isRecording();
 }
 
 bool CameraHandler::releaseCamera()
 {
-    if (webCam_ && webCam_->isOpened())
-    {
-        // Stop the timer to prevent frame capturing during camera switch
-        if (timer && timer->isActive())
-        {
-            timer->stop();
-        }
-
-        // Release the camera resource
-        webCam_->release();
+    // Stop the vision thread to prevent frame capturing during camera switch
+    m_worker->stop();
+    stopRecording();
 
+    // Release the camera resource
+    if (m_worker->releaseSource())
+    {
         // Update UI to show the camera is disconnected
         ui->detectionLabel_->setText("Camera disconnected");
         ui->imageLabel_->setText("No image");
@@ -624,43 +348,50 @@ bool CameraHandler::releaseCamera()
 
 bool CameraHandler::openCamera(int cameraIndex)
 {
-    // If webCam_ doesn't exist, create it
-    if (!webCam_)
+    if (openSource(new CameraFrameSource(cameraIndex)))
     {
-        webCam_ = new VideoCapture();
+        return true;
     }
 
-    // Try to open the camera with the specified index
-    if (webCam_->open(cameraIndex))
+    // Failed to open camera, update UI
+    ui->detectionLabel_->setText(QString("Error opening camera %1").arg(cameraIndex));
+    return false;
+}
+
+bool CameraHandler::openReplay(const QString &path, bool realTime)
+{
+    FrameSource::Pacing pacing = realTime ? FrameSource::RealTime : FrameSource::AsFastAsPossible;
+    if (openSource(FrameSource::createFromPath(path, pacing)))
     {
-        // Get camera information
-        int width = webCam_->get(CAP_PROP_FRAME_WIDTH);
-        int height = webCam_->get(CAP_PROP_FRAME_HEIGHT);
+        return true;
+    }
 
-        // Reset detection states for the new camera
-        hasReference = false;
-        hasDetection = false;
-        consecutiveDetections = 0;
+    ui->detectionLabel_->setText(QString("Error opening replay %1").arg(path));
+    return false;
+}
 
-        // Initialize hand position to middle of new camera frame
-        m_handPosition[0] = width > 0 ? width / 2 : 320;
-        m_handPosition[1] = height > 0 ? height / 2 : 240;
+bool CameraHandler::openSource(FrameSource *source)
+{
+    // The worker must be idle while its source is being replaced, a recording does not span two sources
+    m_worker->stop();
+    stopRecording();
+    for (HandSampleHistory &history : m_handHistories)
+    {
+        history.clear();
+    }
 
-        // Update UI with new camera information
-        ui->detectionLabel_->setText(QString("Video ok, image size is %1x%2 pixels").arg(width).arg(height));
+    // The worker takes ownership of the source, even if it cannot be opened
+    if (m_worker->openSource(source))
+    {
+        // Update UI with new source information
+        QSize size = m_worker->frameSize();
+        ui->detectionLabel_->setText(QString("Video ok, image size is %1x%2 pixels").arg(size.width()).arg(size.height()));
 
-        // Start or restart the timer for frame updates
-        if (timer)
-        {
-            timer->start(30);
-        }
+        // Start or restart the vision thread
+        m_worker->setPreviewSize(ui->imageLabel_->size());
+        m_worker->start();
 
         return true;
     }
-    else
-    {
-        // Failed to open camera, update UI
-        ui->detectionLabel_->setText(QString("Error opening camera %1").arg(cameraIndex));
-        return false;
-    }
+    return false;
 }
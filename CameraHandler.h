@@ -1,13 +1,22 @@
 #ifndef CAMERAHANDLER_H
 #define CAMERAHANDLER_H
 
-#include "opencv2/opencv.hpp"
 #include <QWidget>
-#include <QTimer>
-#include <QElapsedTimer>
+#include <QImage>
 #include <QVector3D>
+#include <QPoint>
+#include "vision/handSample.h"
+#include "vision/handSampleHistory.h"
+#include "vision/visionSettings.h"
+#include "vision/visionStats.h"
 
-using namespace cv;
+class VisionWorker;
+class FrameSource;
+
+namespace cv
+{
+    class Mat;
+}
 
 namespace Ui
 {
@@ -18,10 +27,15 @@ namespace Ui
  * @brief The CameraHandler class manages webcam operations for hand detection and tracking
  *
  * This class provides functionality to:
- * - Capture video from a webcam
+ * - Capture video from a webcam, or replay a recorded session
  * - Detect hand positions using Haar cascades
  * - Establish a reference image after consistent detection
- * - Track hand position using SIFT feature matching
+ * - Track hand position using feature matching (backend selectable at runtime)
+ * - Record the session (raw frames, timestamps and tracker outputs) to disk
+ *
+ * Capture and detection run on a dedicated VisionWorker thread. The widget only
+ * displays the preview and exposes the latest hand sample, which is read without
+ * blocking so the render loop is never held up by vision work.
  *
  * @author Estevan SCHMITT
  */
@@ -37,10 +51,82 @@ public:
     explicit CameraHandler(QWidget *parent = 0);
 
     /**
-     * @brief Destructor releases resources like timer and webcam
+     * @brief Destructor stops the vision worker and releases the webcam
      */
     ~CameraHandler();
 
+    /**
+     * @brief Get the latest hand sample published by the vision worker
+     * @param hand Index of the hand (1 is only tracked in two-hands mode)
+     * @return Latest sample (invalid until the first frame has been processed)
+     *
+     * Lock-free and non-blocking, meant to be called from the game loop.
+     * New trusted samples are also added to the hand position history.
+     */
+    HandSample latestHandSample(int hand = 0) const;
+
+    /**
+     * @brief Get the hand position at a given time from the recent samples
+     * @param timeNs Time to compute the position at (visionClockNs()), usually when the rendered frame is shown
+     * @param position Receives the normalized position, interpolated between samples or extrapolated after the newest one
+     * @param hand Index of the hand
+     * @return false if the hand has not been tracked yet
+     *
+     * Call latestHandSample() first so the history includes the newest sample.
+     */
+    bool handPositionAt(qint64 timeNs, QVector3D &position, int hand = 0) const;
+
+    /**
+     * @brief Converts a hand sample to normalized coordinates
+     * @param sample Hand sample in frame pixels
+     * @return Normalized 3D vector between (-1,-1,0) and (1,1,0)
+     */
+    static QVector3D toNormalizedPosition(const HandSample &sample);
+
+    /**
+     * @brief Get the latest counters of the vision pipeline
+     * @return Snapshot published after the last processed frame
+     */
+    VisionStats visionStats() const;
+
+    /**
+     * @brief Get the latency percentiles of a pipeline stage
+     * @param stage Stage of the vision pipeline
+     * @return p50, p95, p99 and max over the last frames, in milliseconds
+     */
+    LatencySummary stageLatency(VisionProfiler::Stage stage) const;
+
+    /**
+     * @brief Formats the latency percentiles of all the stages
+     * @return One line per stage that ran recently: name, p50, p95 and p99
+     */
+    QString latencyReport() const;
+
+    /**
+     * @brief Get the latest annotated camera frame without copying it
+     * @return Mirrored BGR frame if a new one was processed since the previous call, nullptr otherwise
+     *
+     * The frame stays valid until the next call, meant to be uploaded to a texture by the render loop.
+     * Frames are only published while setFramePreviewEnabled() is on.
+     */
+    const cv::Mat *acquireLatestFrame();
+
+    /**
+     * @brief Publishes the annotated frames for acquireLatestFrame()
+     * @param enabled true when the render loop draws the camera preview
+     *
+     * The worker skips the full resolution frame copy while it is disabled.
+     */
+    void setFramePreviewEnabled(bool enabled);
+
+    /**
+     * @brief Shows or hides the preview image in the camera panel
+     * @param enabled false when the preview is drawn elsewhere from acquireLatestFrame()
+     *
+     * The worker does not build the scaled preview image while it is disabled.
+     */
+    void setImagePreviewEnabled(bool enabled);
+
     /**
      * @brief Get the hand/sword position detected by the camera
      * @return Normalized 3D vector between (-1,-1,0) and (1,1,0)
@@ -56,16 +142,7 @@ public:
      * @brief Get the current tracked hand position in screen coordinates
      * @return QPoint containing the x,y coordinates of the tracked hand
      */
-    QPoint getTrackedHandPosition() const { return QPoint(m_handPosition[0], m_handPosition[1]); }
-
-    /**
-     * @brief Set the tracked hand position
-     * @param x X-coordinate of the hand position
-     * @param y Y-coordinate of the hand position
-     *
-     * Updates the internal tracking of hand position that controls the player's sword.
-     */
-    void setTrackedHandPosition(int x, int y);
+    QPoint getTrackedHandPosition() const;
 
     /**
      * @brief Releases the current camera connection
@@ -80,73 +157,110 @@ public:
      */
     bool openCamera(int cameraIndex);
 
-private:
-    Ui::CameraHandler *ui; // Pointer to the UI components
-    VideoCapture *webCam_; // Pointer to the webcam capture object
+    /**
+     * @brief Replays a recorded session instead of the camera
+     * @param path Video file or directory of images
+     * @param realTime true to replay at the recorded frame rate, false to process frames as fast as possible
+     * @return true if successful, false otherwise
+     */
+    bool openReplay(const QString &path, bool realTime = true);
 
-    Mat reference;     // Reference image for SIFT matching
-    bool hasReference; // Flag indicating if a reference image has been captured
+    /**
+     * @brief Replaces the source of the frames processed by the vision worker
+     * @param source Opened frame source, ownership is transferred to the worker
+     * @return true if successful, false otherwise
+     */
+    bool openSource(FrameSource *source);
 
-    QTimer *timer;                // Timer for periodic updates
-    QElapsedTimer detectionTimer; // Timer for detection duration
+    /**
+     * @brief Get the current vision pipeline configuration
+     * @return Current settings
+     */
+    VisionSettings visionSettings() const { return m_settings; }
 
-    Rect lastDetectedRect;     // Last detected rectangle for hand position
-    bool hasDetection;         // Flag indicating if a hand has been detected
-    int consecutiveDetections; // Count of consecutive detections
+    /**
+     * @brief Changes the vision pipeline configuration
+     * @param settings New settings, applied by the vision thread before its next frame
+     */
+    void setVisionSettings(const VisionSettings &settings);
 
-    static const int REQUIRED_DETECTIONS = 5; // Number of detections required to capture a reference image
-    int matchQuality; // Quality of the SIFT match (0-100)
+    /**
+     * @brief Selects the detector used to find the hand
+     * @param backend Detector backend
+     */
+    void setDetectorBackend(VisionSettings::DetectorBackend backend);
 
-    bool debug; // Flag for enabling/disabling debug mode
-    const float m_siftRationTresh = 0.85f; // SIFT ratio threshold for matching
+    /**
+     * @brief Selects the feature tracker used once the hand reference is captured
+     * @param backend Tracker backend
+     */
+    void setTrackerBackend(HandTracker::Backend backend);
 
     /**
-     * @brief Stores the tracked hand position in screen coordinates
-     * [0] = x-coordinate, [1] = y-coordinate
+     * @brief Enables or disables the tracking of a second hand
+     * @param enabled true to track up to two hands with the same detections
      */
-    int m_handPosition[2];
+    void setTwoHandsEnabled(bool enabled);
 
-    bool isDetectionClose(const Rect &current, const Rect &previous);
+    /**
+     * @brief Check if a second hand is tracked
+     * @return true in two-hands mode
+     */
+    bool isTwoHandsEnabled() const { return m_settings.maxHands > 1; }
 
     /**
-     * @brief Performs SIFT feature matching between two images
-     * @param image1 Reference image
-     * @param image2 Current image for comparison
-     * @return Vector of keypoints from the matched image
+     * @brief Starts recording the processed frames and tracker outputs
+     * @param directory Session directory, empty for a new timestamped directory in the application data
+     * @return true if the recording started
+     *
+     * The frames are written by a background thread, see SessionRecorder. The
+     * recording stops when the source is replaced or released.
      */
-    std::vector<KeyPoint> applySIFT(Mat &image1, Mat &image2);
+    bool startRecording(const QString &directory = QString());
 
     /**
-     * @brief Detects hand using Haar cascade classifiers
-     * @param image Input image to process
-     * @return Rectangle containing detected hand (empty if no detection)
+     * @brief Stops the recording, after the queued frames are written
      */
-    Rect haarCascade(Mat &image);
+    void stopRecording();
 
     /**
-     * @brief Captures reference image when hand is consistently detected
+     * @brief Check if the session is being recorded
+     * @return true between startRecording() and stopRecording()
      */
-    void captureReference();
+    bool isRecording() const;
 
+signals:
     /**
-     * @brief Updates UI status text based on current detection state
+     * @brief Signal emitted when the two-hands mode is toggled
+     * @param enabled true if a second hand is now tracked
      */
-    void updateStatusText();
+    void twoHandsChanged(bool enabled);
 
     /**
-     * @brief Rotates an image by a given angle
-     * @param src Source image
-     * @param angle Rotation angle in degrees
-     * @return Rotated image
+     * @brief Signal emitted when a recording starts or stops
+     * @param recording true if the session is now recorded
      */
-    Mat rotateImage(const Mat &src, float angle);
+    void recordingChanged(bool recording);
+
+private:
+    Ui::CameraHandler *ui; // Pointer to the UI components
+    VisionWorker *m_worker; // Vision thread owning the webcam and the detection pipeline
+    mutable HandSample m_latestSamples[VisionSettings::MAX_HANDS]; // Last sample of each hand read from the worker mailboxes
+    mutable HandSampleHistory m_handHistories[VisionSettings::MAX_HANDS]; // Timestamped filtered positions of the recent samples of each hand
+    mutable VisionStats m_latestStats; // Last counters read from the worker mailbox
+    VisionSettings m_settings; // Current vision pipeline configuration
+    int m_framesSinceLatencyUpdate; // Frames displayed since the latency overlay was refreshed
+
+    static const int LATENCY_REFRESH_FRAMES = 10; // Refresh period of the latency overlay, in frames
+    static constexpr float MIN_HISTORY_CONFIDENCE = 0.1f; // Samples less trusted than this are kept out of the history
 
 private slots:
     /**
-     * @brief Updates and processes each video frame
-     * Handles detection, tracking, and UI updates
+     * @brief Displays the preview and status of a frame processed by the vision worker
+     * @param preview Annotated preview image
+     * @param status Detection status text
      */
-    void updateFrame();
+    void onFrameProcessed(const QImage &preview, const QString &status);
 };
 
 #endif // CAMERAHANDLER_H
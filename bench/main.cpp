@@ -0,0 +1,259 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include "visionBench.h"
+
+/**
+ * @brief Parses a comma separated list of numbers
+ * @param text List such as "3,5,8"
+ * @param values Receives the numbers
+ * @return false if an entry is not a number
+ */
+static bool parseList(const QString &text, QList<double> &values)
+{
+    // Qt::SkipEmptyParts replaced QString::SkipEmptyParts in Qt 5.14
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    const QStringList entries = text.split(',', Qt::SkipEmptyParts);
+#else
+    const QStringList entries = text.split(',', QString::SkipEmptyParts);
+#endif
+    for (const QString &entry : entries)
+    {
+        bool ok = false;
+        values << entry.trimmed().toDouble(&ok);
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return !values.isEmpty();
+}
+
+/**
+ * @brief Parses the format of the synthetic frames
+ * @param text Format such as "1920x1080@120"
+ * @param size Receives the frame size
+ * @param frameRate Receives the frame rate (30 if omitted)
+ * @return false if the format is malformed
+ */
+static bool parseFormat(const QString &text, Size &size, double &frameRate)
+{
+    QStringList parts = text.split('@');
+    QStringList dimensions = parts.first().split('x');
+    bool widthOk = false, heightOk = false, rateOk = true;
+    if (parts.size() > 2 || dimensions.size() != 2)
+    {
+        return false;
+    }
+    size = Size(dimensions[0].toInt(&widthOk), dimensions[1].toInt(&heightOk));
+    frameRate = parts.size() == 2 ? parts[1].toDouble(&rateOk) : 30.0;
+    return widthOk && heightOk && rateOk && size.width >= 64 && size.height >= 64 && frameRate > 0.0;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("slice-vision-bench");
+
+    // Command line options
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs the hand detection and tracking pipeline over an annotated recording, "
+                                     "or over rendered frames, and reports throughput, latency and accuracy for each configuration.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("directory", "Directory of recorded images holding annotations.csv (file,x,y,width,height), "
+                                              "unless --synthetic is given.");
+    QCommandLineOption detectorOption("detector", "Detector backend: haar, skin or all.", "name", "all");
+    QCommandLineOption trackerOption("tracker", "Tracker backend: sift, orb, brisk, akaze, template or all.", "name", "all");
+    QCommandLineOption requiredOption("required-detections", "Comma separated detection counts before the reference capture.", "list", "5");
+    QCommandLineOption ratioOption("match-ratio", "Comma separated Lowe ratio thresholds, 0 for the backend default.", "list", "0");
+    QCommandLineOption noFlowOption("no-flow", "Run the detector on every frame instead of following the hand with optical flow.");
+    QCommandLineOption csvOption("csv", "Also write the results to a CSV file.", "file");
+    QCommandLineOption verboseOption("verbose", "Keep the per-frame log of the pipeline.");
+    QCommandLineOption syntheticOption("synthetic", "Render the frames instead of reading a recording, e.g. 1920x1080@120.", "format");
+    QCommandLineOption framesOption("frames", "Number of rendered frames per configuration.", "count", "600");
+    QCommandLineOption blobOption("blob", "Render a plain skin coloured blob on a plain background instead of a hand on a texture.");
+    QCommandLineOption scaleOption("hand-scale", "Hand height relative to a quarter of the frame height.", "factor", "1");
+    QCommandLineOption scaleVariationOption("scale-variation", "Relative amplitude of the hand size oscillation.", "ratio", "0.15");
+    QCommandLineOption lightingOption("lighting-variation", "Relative amplitude of the brightness oscillation.", "ratio", "0.2");
+    QCommandLineOption noiseOption("noise", "Standard deviation of the sensor noise in grey levels.", "sigma", "4");
+    QCommandLineOption maxErrorOption("max-center-error", "Exit with status 2 if the 95th percentile centre error of a "
+                                                          "configuration exceeds this bound, or if it never tracks the hand.", "pixels");
+    parser.addOption(detectorOption);
+    parser.addOption(trackerOption);
+    parser.addOption(requiredOption);
+    parser.addOption(ratioOption);
+    parser.addOption(noFlowOption);
+    parser.addOption(csvOption);
+    parser.addOption(verboseOption);
+    parser.addOption(syntheticOption);
+    parser.addOption(framesOption);
+    parser.addOption(blobOption);
+    parser.addOption(scaleOption);
+    parser.addOption(scaleVariationOption);
+    parser.addOption(lightingOption);
+    parser.addOption(noiseOption);
+    parser.addOption(maxErrorOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    bool synthetic = parser.isSet(syntheticOption);
+    if (parser.positionalArguments().size() != (synthetic ? 0 : 1))
+    {
+        parser.showHelp(1);
+    }
+
+    // Backends to run, in VisionSettings and HandTracker order
+    QStringList detectorNames = QStringList() << "haar" << "skin";
+    QStringList trackerNames = QStringList() << "sift" << "orb" << "brisk" << "akaze" << "template";
+    QString detector = parser.value(detectorOption).toLower();
+    QString tracker = parser.value(trackerOption).toLower();
+    QStringList detectors = detector == "all" ? detectorNames : QStringList() << detector;
+    QStringList trackers = tracker == "all" ? trackerNames : QStringList() << tracker;
+    for (const QString &name : detectors)
+    {
+        if (!detectorNames.contains(name))
+        {
+            err << "Unknown detector " << name << "\n";
+            return 1;
+        }
+    }
+    for (const QString &name : trackers)
+    {
+        if (!trackerNames.contains(name))
+        {
+            err << "Unknown tracker " << name << "\n";
+            return 1;
+        }
+    }
+
+    QList<double> requiredDetections, matchRatios;
+    if (!parseList(parser.value(requiredOption), requiredDetections) || !parseList(parser.value(ratioOption), matchRatios))
+    {
+        err << "Expected comma separated numbers for --required-detections and --match-ratio\n";
+        return 1;
+    }
+
+    bool maxErrorOk = true;
+    double maxCenterError = parser.isSet(maxErrorOption) ? parser.value(maxErrorOption).toDouble(&maxErrorOk) : 0.0;
+    if (!maxErrorOk || maxCenterError < 0.0)
+    {
+        err << "Expected a positive number for --max-center-error\n";
+        return 1;
+    }
+
+    VisionBench bench;
+    if (synthetic)
+    {
+        Size size;
+        double frameRate = 30.0;
+        if (!parseFormat(parser.value(syntheticOption), size, frameRate))
+        {
+            err << "Expected WIDTHxHEIGHT[@FPS] for --synthetic\n";
+            return 1;
+        }
+
+        SyntheticFrameSource::Scene scene;
+        if (!parser.isSet(blobOption))
+        {
+            scene.handTemplate = SyntheticFrameSource::createHandTemplate(size.height / 2, scene.handMask);
+            scene.texturedBackground = true;
+        }
+        scene.handScale = parser.value(scaleOption).toDouble();
+        scene.scaleVariation = parser.value(scaleVariationOption).toDouble();
+        scene.lightingVariation = parser.value(lightingOption).toDouble();
+        scene.noiseSigma = parser.value(noiseOption).toDouble();
+        if (scene.handScale <= 0.0)
+        {
+            err << "Expected a positive number for --hand-scale\n";
+            return 1;
+        }
+        bench.openSynthetic(size, frameRate, parser.value(framesOption).toInt(), scene);
+    }
+    else
+    {
+        QString error;
+        if (!bench.open(parser.positionalArguments().first(), error))
+        {
+            err << error << "\n";
+            return 1;
+        }
+    }
+
+    // One configuration per combination of the selected values
+    QList<BenchConfig> configs;
+    for (const QString &detectorName : detectors)
+    {
+        for (const QString &trackerName : trackers)
+        {
+            for (double required : requiredDetections)
+            {
+                for (double ratio : matchRatios)
+                {
+                    BenchConfig config;
+                    config.settings.detectorBackend = static_cast<VisionSettings::DetectorBackend>(detectorNames.indexOf(detectorName));
+                    config.settings.trackerBackend = static_cast<HandTracker::Backend>(trackerNames.indexOf(trackerName));
+                    config.settings.requiredDetections = qMax(1, static_cast<int>(required));
+                    config.settings.matchRatio = static_cast<float>(ratio);
+                    config.settings.opticalFlowEnabled = !parser.isSet(noFlowOption);
+                    config.name = QString("%1/%2 req=%3 ratio=%4")
+                                      .arg(detectorName, trackerName)
+                                      .arg(config.settings.requiredDetections)
+                                      .arg(ratio > 0.0 ? QString::number(ratio) : QString("default"));
+                    configs << config;
+                }
+            }
+        }
+    }
+
+    // The pipeline logs every frame on the standard output, which would bury the report
+    bench.setVerbose(parser.isSet(verboseOption));
+
+    QList<BenchResult> results;
+    for (const BenchConfig &config : configs)
+    {
+        err << "Running " << config.name << "...\n";
+        err.flush();
+        results << bench.run(config);
+    }
+
+    out << bench.annotationCount() << (synthetic ? " rendered frames\n" : " annotated frames\n");
+    out << VisionBench::tableHeader() << "\n";
+    for (const BenchResult &result : results)
+    {
+        out << VisionBench::tableRow(result) << "\n";
+    }
+    out.flush();
+
+    if (parser.isSet(csvOption))
+    {
+        QFile csv(parser.value(csvOption));
+        if (!csv.open(QIODevice::WriteOnly | QIODevice::Text))
+        {
+            err << "Cannot write " << csv.fileName() << "\n";
+            return 1;
+        }
+        QTextStream csvOut(&csv);
+        csvOut << VisionBench::csvHeader() << "\n";
+        for (const BenchResult &result : results)
+        {
+            csvOut << VisionBench::csvRow(result) << "\n";
+        }
+    }
+
+    // Tracking accuracy bound for automated runs
+    int status = 0;
+    if (parser.isSet(maxErrorOption))
+    {
+        for (const BenchResult &result : results)
+        {
+            if (result.positionsUpdated == 0 || result.centerErrorPercentile(95.0) > maxCenterError)
+            {
+                err << result.name << ": 95th percentile centre error above " << maxCenterError << " px\n";
+                status = 2;
+            }
+        }
+    }
+    return status;
+}
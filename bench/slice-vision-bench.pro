@@ -0,0 +1,28 @@
+# configuration Qt
+# Offline benchmark of the vision pipeline, no widget: runs over annotated recordings
+QT       += core gui concurrent
+
+CONFIG   += console
+CONFIG   -= app_bundle
+
+TEMPLATE  = app
+
+# nom de l'exe genere
+TARGET 	  = slice-vision-bench
+
+# fichiers sources/headers
+SOURCES	+= main.cpp \
+    visionBench.cpp
+
+HEADERS += \
+    visionBench.h
+
+# vision/ headers are included from the project root, like in the game
+INCLUDEPATH += ..
+
+# Haar cascades are loaded from the game resources
+RESOURCES += \
+    ../res/textures.qrc
+
+# vision pipeline and OpenCV, shared with the game
+include(../vision/vision.pri)
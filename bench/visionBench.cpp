@@ -0,0 +1,281 @@
+#include "visionBench.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include "vision/frameSource.h"
+#include "vision/visionPipeline.h"
+
+double BenchResult::centerErrorPercentile(double percent) const
+{
+    if (centerErrors.empty())
+    {
+        return 0.0;
+    }
+
+    // Nearest-rank percentile, like LatencyHistogram
+    std::vector<double> sorted(centerErrors);
+    int count = static_cast<int>(sorted.size());
+    int rank = std::max(0, std::min(count - 1, static_cast<int>(std::ceil(percent / 100.0 * count)) - 1));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+double BenchResult::meanCenterError() const
+{
+    if (centerErrors.empty())
+    {
+        return 0.0;
+    }
+
+    double sum = 0.0;
+    for (double error : centerErrors)
+    {
+        sum += error;
+    }
+    return sum / centerErrors.size();
+}
+
+bool VisionBench::open(const QString &directory, QString &error)
+{
+    m_syntheticFrames = 0;
+    m_directory = directory;
+    m_truth.clear();
+
+    QFile file(QDir(directory).filePath("annotations.csv"));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        error = QString("Cannot open %1").arg(file.fileName());
+        return false;
+    }
+
+    QTextStream in(&file);
+    int lineNumber = 0;
+    while (!in.atEnd())
+    {
+        QString line = in.readLine().trimmed();
+        lineNumber++;
+
+        // Comments, blank lines and the optional header are skipped
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith("file,"))
+        {
+            continue;
+        }
+
+        QStringList fields = line.split(',');
+        bool ok = fields.size() == 5;
+        int values[4] = {0, 0, 0, 0};
+        for (int i = 0; ok && i < 4; i++)
+        {
+            values[i] = fields[i + 1].trimmed().toInt(&ok);
+        }
+        if (!ok)
+        {
+            error = QString("%1:%2: expected file,x,y,width,height").arg(file.fileName()).arg(lineNumber);
+            return false;
+        }
+        m_truth.insert(fields[0].trimmed(), Rect(values[0], values[1], std::max(0, values[2]), std::max(0, values[3])));
+    }
+
+    if (m_truth.isEmpty())
+    {
+        error = QString("No annotation in %1").arg(file.fileName());
+        return false;
+    }
+
+    ImageSequenceFrameSource source(directory);
+    if (!source.isOpened())
+    {
+        error = QString("No image in %1").arg(directory);
+        return false;
+    }
+    return true;
+}
+
+void VisionBench::openSynthetic(const Size &size, double frameRate, int frameCount, const SyntheticFrameSource::Scene &scene)
+{
+    m_directory.clear();
+    m_truth.clear();
+    m_syntheticSize = size;
+    m_syntheticRate = frameRate;
+    m_syntheticFrames = std::max(1, frameCount);
+    m_scene = scene;
+}
+
+BenchResult VisionBench::run(const BenchConfig &config) const
+{
+    // Frames are read as fast as the pipeline takes them, the reading time is not measured
+    if (isSynthetic())
+    {
+        SyntheticFrameSource source(m_syntheticSize, m_syntheticRate, FrameSource::AsFastAsPossible);
+        source.setScene(m_scene);
+        return measure(config, source, m_syntheticFrames, [&source](Rect &truth) {
+            truth = source.handRect(source.frameIndex() - 1);
+            return true;
+        });
+    }
+
+    ImageSequenceFrameSource source(m_directory, 30.0, FrameSource::AsFastAsPossible);
+    if (!source.isOpened())
+    {
+        BenchResult result;
+        result.name = config.name;
+        return result;
+    }
+    return measure(config, source, source.frameCount(), [this, &source](Rect &truth) {
+        auto found = m_truth.constFind(source.currentFileName());
+        if (found == m_truth.constEnd())
+        {
+            return false;
+        }
+        truth = *found;
+        return true;
+    });
+}
+
+BenchResult VisionBench::measure(const BenchConfig &config, FrameSource &source, int frameLimit,
+                                 const std::function<bool(Rect &)> &truthOf) const
+{
+    BenchResult result;
+    result.name = config.name;
+
+    VisionPipeline pipeline;
+    pipeline.setLogEnabled(m_verbose);
+    pipeline.applySettings(config.settings);
+    pipeline.reset(&source, source.frameSize().width(), source.frameSize().height());
+
+    // Every frame is kept in the distribution
+    LatencyHistogram latency(std::max(1, frameLimit));
+    QElapsedTimer timer;
+    Mat frame;
+
+    while (result.frames < frameLimit && source.read(frame))
+    {
+        // The pipeline reads nothing itself, the truth of the frame just read is taken before processing it
+        Rect truth;
+        bool annotated = truthOf(truth);
+
+        timer.start();
+        pipeline.processFrame(frame);
+        double ms = timer.nsecsElapsed() / 1.0e6;
+        latency.add(ms);
+        result.totalMs += ms;
+
+        if (result.lockFrame < 0 && pipeline.isTracking())
+        {
+            result.lockFrame = result.frames;
+        }
+        result.frames++;
+
+        if (!annotated)
+        {
+            continue;
+        }
+
+        const Rect &found = pipeline.handRect();
+        if (truth.empty())
+        {
+            result.emptyFrames++;
+            result.falsePositives += found.empty() ? 0 : 1;
+            continue;
+        }
+
+        // The pipeline works on the mirrored frame
+        Rect expected(frame.cols - truth.x - truth.width, truth.y, truth.width, truth.height);
+        result.handFrames++;
+
+        if (!found.empty())
+        {
+            double intersection = (found & expected).area();
+            double iou = intersection / (found.area() + expected.area() - intersection);
+            result.regionsFound++;
+            result.iouSum += iou;
+            result.iouHits += iou >= 0.5 ? 1 : 0;
+        }
+
+        // The position the game would receive, only when it was updated on this frame
+        if (pipeline.trackingConfidence() > 0.0)
+        {
+            QPoint position = pipeline.trackedHandPosition();
+            Point2f offset(position.x() - (expected.x + expected.width / 2.0f),
+                           position.y() - (expected.y + expected.height / 2.0f));
+            result.positionsUpdated++;
+            result.centerErrors.push_back(std::sqrt(offset.dot(offset)));
+        }
+    }
+
+    result.latency = latency.summary();
+    result.detectionRatio = pipeline.stats().detectionRatio();
+    return result;
+}
+
+QString VisionBench::tableHeader()
+{
+    return QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12 %13 %14")
+        .arg("configuration", -32)
+        .arg("fps", 7)
+        .arg("p50 ms", 7)
+        .arg("p95 ms", 7)
+        .arg("p99 ms", 7)
+        .arg("max ms", 7)
+        .arg("det %", 6)
+        .arg("FP", 4)
+        .arg("IoU", 5)
+        .arg("IoU>.5", 7)
+        .arg("err px", 7)
+        .arg("p95 px", 7)
+        .arg("lock", 5)
+        .arg("detect%", 7);
+}
+
+QString VisionBench::tableRow(const BenchResult &result)
+{
+    return QString("%1 %2 %3 %4 %5 %6 %7 %8 %9 %10 %11 %12 %13 %14")
+        .arg(result.name, -32)
+        .arg(result.fps(), 7, 'f', 1)
+        .arg(result.latency.p50, 7, 'f', 1)
+        .arg(result.latency.p95, 7, 'f', 1)
+        .arg(result.latency.p99, 7, 'f', 1)
+        .arg(result.latency.max, 7, 'f', 1)
+        .arg(result.detectionRate() * 100.0, 6, 'f', 1)
+        .arg(result.falsePositives, 4)
+        .arg(result.meanIou(), 5, 'f', 2)
+        .arg(result.handFrames > 0 ? result.iouHits * 100.0 / result.handFrames : 0.0, 7, 'f', 1)
+        .arg(result.meanCenterError(), 7, 'f', 1)
+        .arg(result.centerErrorPercentile(95.0), 7, 'f', 1)
+        .arg(result.lockFrame, 5)
+        .arg(result.detectionRatio * 100.0, 7, 'f', 1);
+}
+
+QString VisionBench::csvHeader()
+{
+    return "configuration,frames,fps,p50_ms,p95_ms,p99_ms,max_ms,hand_frames,empty_frames,detection_rate,"
+           "false_positives,mean_iou,iou50_rate,tracking_rate,center_error_mean_px,center_error_p95_px,lock_frame,"
+           "detection_frame_ratio";
+}
+
+QString VisionBench::csvRow(const BenchResult &result)
+{
+    QStringList values;
+    values << result.name
+           << QString::number(result.frames)
+           << QString::number(result.fps(), 'f', 2)
+           << QString::number(result.latency.p50, 'f', 3)
+           << QString::number(result.latency.p95, 'f', 3)
+           << QString::number(result.latency.p99, 'f', 3)
+           << QString::number(result.latency.max, 'f', 3)
+           << QString::number(result.handFrames)
+           << QString::number(result.emptyFrames)
+           << QString::number(result.detectionRate(), 'f', 4)
+           << QString::number(result.falsePositives)
+           << QString::number(result.meanIou(), 'f', 4)
+           << QString::number(result.handFrames > 0 ? double(result.iouHits) / result.handFrames : 0.0, 'f', 4)
+           << QString::number(result.trackingRate(), 'f', 4)
+           << QString::number(result.meanCenterError(), 'f', 2)
+           << QString::number(result.centerErrorPercentile(95.0), 'f', 2)
+           << QString::number(result.lockFrame)
+           << QString::number(result.detectionRatio, 'f', 4);
+    return values.join(',');
+}
@@ -0,0 +1,194 @@
+#ifndef VISIONBENCH_H
+#define VISIONBENCH_H
+
+#include "opencv2/opencv.hpp"
+#include <QHash>
+#include <QString>
+#include <functional>
+#include <vector>
+#include "vision/latencyHistogram.h"
+#include "vision/syntheticFrameSource.h"
+#include "vision/visionSettings.h"
+
+using namespace cv;
+
+/**
+ * @brief One pipeline configuration measured by the benchmark
+ */
+struct BenchConfig
+{
+    QString name;            // Short description shown in the report
+    VisionSettings settings; // Settings the pipeline runs with
+};
+
+/**
+ * @brief Throughput, latency and accuracy of one configuration over a recording
+ *
+ * Accuracy is only computed on the frames listed in the annotations, or on every
+ * frame of a synthetic run.
+ */
+struct BenchResult
+{
+    QString name;              // Name of the configuration
+    int frames = 0;            // Frames processed
+    double totalMs = 0.0;      // Time spent in VisionPipeline::processFrame() over all frames
+    LatencySummary latency;    // Per-frame processing latency (milliseconds)
+
+    int handFrames = 0;        // Annotated frames showing a hand
+    int emptyFrames = 0;       // Annotated frames without a hand
+    int regionsFound = 0;      // Hand frames where the pipeline found a region
+    int falsePositives = 0;    // Empty frames where the pipeline found a region
+    double iouSum = 0.0;       // Sum of the IoU of the found regions with the ground truth
+    int iouHits = 0;           // Found regions with an IoU of at least 0.5
+    int positionsUpdated = 0;  // Hand frames where the tracked position was updated
+    std::vector<double> centerErrors; // Distance between the tracked position and the box centre (pixels)
+    int lockFrame = -1;        // Index of the frame the reference was captured on (-1 if never)
+    double detectionRatio = 0.0; // Share of the frames that ran the full detection (VisionStats::detectionRatio())
+
+    /**
+     * @brief Get the throughput
+     * @return Processed frames per second of processing time
+     */
+    double fps() const { return totalMs > 0.0 ? frames * 1000.0 / totalMs : 0.0; }
+
+    /**
+     * @brief Get the share of hand frames where a region was found
+     * @return Detection rate between 0 and 1
+     */
+    double detectionRate() const { return handFrames > 0 ? double(regionsFound) / handFrames : 0.0; }
+
+    /**
+     * @brief Get the mean IoU of the found regions
+     * @return IoU between 0 and 1
+     */
+    double meanIou() const { return regionsFound > 0 ? iouSum / regionsFound : 0.0; }
+
+    /**
+     * @brief Get the share of hand frames where the position was updated
+     * @return Tracking rate between 0 and 1
+     */
+    double trackingRate() const { return handFrames > 0 ? double(positionsUpdated) / handFrames : 0.0; }
+
+    /**
+     * @brief Computes a percentile of the centre errors
+     * @param percent Percentile between 0 and 100
+     * @return Error in pixels, 0 if the position was never updated
+     */
+    double centerErrorPercentile(double percent) const;
+
+    /**
+     * @brief Computes the mean centre error
+     * @return Error in pixels, 0 if the position was never updated
+     */
+    double meanCenterError() const;
+};
+
+/**
+ * @brief Runs the vision pipeline over an annotated recording, without any widget
+ *
+ * The recording is a directory of images (as written by a frame dump or a session
+ * recording) holding an annotations.csv file with one line per annotated frame:
+ *
+ *     file,x,y,width,height
+ *
+ * The box is given in the coordinates of the recorded image, before the pipeline
+ * mirrors it; a zero width or height marks a frame without hand. Frames missing from
+ * the file are processed but not scored.
+ *
+ * It can also run over frames rendered by a SyntheticFrameSource, at any resolution
+ * and frame rate, scored against the scripted hand box of every frame.
+ */
+class VisionBench
+{
+public:
+    /**
+     * @brief Loads the annotations of a recording
+     * @param directory Directory of images holding annotations.csv
+     * @param error Receives the reason of a failure
+     * @return true if the recording has frames and annotations
+     */
+    bool open(const QString &directory, QString &error);
+
+    /**
+     * @brief Uses rendered frames instead of a recording
+     * @param size Size of the frames
+     * @param frameRate Frame rate of the scripted motion
+     * @param frameCount Number of frames of each run
+     * @param scene Hand, background and perturbations of the frames
+     */
+    void openSynthetic(const Size &size, double frameRate, int frameCount, const SyntheticFrameSource::Scene &scene);
+
+    /**
+     * @brief Check if the runs use rendered frames
+     * @return true after openSynthetic()
+     */
+    bool isSynthetic() const { return m_syntheticFrames > 0; }
+
+    /**
+     * @brief Runs a configuration over the whole recording
+     * @param config Configuration to measure
+     * @return Measures of the configuration
+     */
+    BenchResult run(const BenchConfig &config) const;
+
+    /**
+     * @brief Keeps or silences the per-frame log of the pipeline
+     * @param verbose true to print the log of every frame on the standard output
+     */
+    void setVerbose(bool verbose) { m_verbose = verbose; }
+
+    /**
+     * @brief Get the number of annotated frames
+     * @return Number of lines read from annotations.csv, or of rendered frames
+     */
+    int annotationCount() const { return isSynthetic() ? m_syntheticFrames : m_truth.size(); }
+
+    /**
+     * @brief Formats the header of the report table
+     * @return Column titles
+     */
+    static QString tableHeader();
+
+    /**
+     * @brief Formats one line of the report table
+     * @param result Measures of a configuration
+     * @return Aligned columns
+     */
+    static QString tableRow(const BenchResult &result);
+
+    /**
+     * @brief Formats the header of the CSV report
+     * @return Comma separated column names
+     */
+    static QString csvHeader();
+
+    /**
+     * @brief Formats one line of the CSV report
+     * @param result Measures of a configuration
+     * @return Comma separated values
+     */
+    static QString csvRow(const BenchResult &result);
+
+private:
+    /**
+     * @brief Runs a configuration over the frames of a source
+     * @param config Configuration to measure
+     * @param source Source of the frames, read as fast as the pipeline takes them
+     * @param frameLimit Maximum number of frames to process
+     * @param truthOf Gives the ground truth box of the frame just read, false if it is not annotated
+     * @return Measures of the configuration
+     */
+    BenchResult measure(const BenchConfig &config, FrameSource &source, int frameLimit,
+                        const std::function<bool(Rect &)> &truthOf) const;
+
+    QString m_directory;        // Directory of the recording
+    QHash<QString, Rect> m_truth; // Ground truth box of each annotated file name
+
+    Size m_syntheticSize;       // Size of the rendered frames
+    double m_syntheticRate = 30.0; // Frame rate of the scripted motion
+    int m_syntheticFrames = 0;  // Frames rendered per run (0 = recording)
+    SyntheticFrameSource::Scene m_scene; // Rendered scene
+    bool m_verbose = false;     // Flag keeping the per-frame log of the pipeline
+};
+
+#endif // VISIONBENCH_H
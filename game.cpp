@@ -1,20 +1,30 @@
 #include "game.h"
+#include "vision/latencyProbe.h"
+#include "vision/visionClock.h"
 #include <QDebug>
+#include <QGuiApplication>
+#include <QScreen>
 
 Game::Game(Player *player, CameraHandler *cameraHandler,
            KeyboardHandler *keyboardHandler,
            ProjectileManager *projectileManager, QObject *parent)
     : QObject(parent),
       m_player(player),
+      m_secondPlayer(nullptr),
       m_cameraHandler(cameraHandler),
       m_keyboardHandler(keyboardHandler),
       m_projectileManager(projectileManager),
       m_score(0),
       m_lives(STANDARD_MODE_LIVES), // Start with Standard Mode lives
       m_gameStarted(false),
+      m_lastSampleSequence(0),
+      m_lastSampleTimeNs(0),
+      m_cameraIntervalNs(0.0),
       m_countdownValue(5),
       m_pointsCounter(0),
-      m_standardMode(true) // Default to Standard Mode
+      m_standardMode(true), // Default to Standard Mode
+      m_twoSwords(false),
+      m_swordCount(0)
 {
     // Initialize timers
     m_updateTimer = new QTimer(this);
@@ -26,6 +36,8 @@ Game::Game(Player *player, CameraHandler *cameraHandler,
     // Initialize the hand position
     m_handPosition = QVector3D(0.0f, 0.0f, 0.0f);
     m_playerPosition = QVector3D(0.0f, 0.0f, 0.0f);
+    m_secondPlayerPosition = QVector3D(0.0f, 0.0f, 0.0f);
+    updateBladeTips();
 
     // Set this Game instance in the ProjectileManager
     if (m_projectileManager)
@@ -44,6 +56,9 @@ void Game::update()
     // Update player position based on input
     updatePlayerPosition();
 
+    // The swords are in place for this frame, the projectiles test them in one pass
+    updateBladeTips();
+
     // Return early if game is not running
     if (!m_gameStarted)
     {
@@ -53,16 +68,40 @@ void Game::update()
 
 void Game::updatePlayerPosition()
 {
-    // Get current hand position from camera handler
-    QVector3D newHandPosition = m_cameraHandler->getHandPosition();
+    // Get the latest hand sample from the vision thread (lock-free, never blocks)
+    HandSample sample = m_cameraHandler->latestHandSample();
+    if (sample.valid && sample.sequence != m_lastSampleSequence)
+    {
+        // Camera frame interval measured from the capture timestamps, over the frames without a sample too
+        if (m_lastSampleTimeNs > 0 && sample.sequence > m_lastSampleSequence && sample.timestampNs > m_lastSampleTimeNs)
+        {
+            double intervalNs = double(sample.timestampNs - m_lastSampleTimeNs) / (sample.sequence - m_lastSampleSequence);
+            m_cameraIntervalNs = m_cameraIntervalNs > 0.0 ? m_cameraIntervalNs + INTERVAL_SMOOTHING * (intervalNs - m_cameraIntervalNs)
+                                                          : intervalNs;
+        }
+        m_lastSampleTimeNs = sample.timestampNs;
+        m_lastSampleSequence = sample.sequence;
+        LatencyProbe::instance().mark(LatencyProbe::GameUpdate, sample.sequence);
+    }
+
+    // Hand position when this frame reaches the screen, interpolated from the timestamped samples
+    // so the sword moves on every rendered frame and not only when a camera frame arrives
+    qint64 displayTimeNs = visionClockNs() + predictionLeadNs();
+    QVector3D newHandPosition;
+    bool validPosition = m_cameraHandler->handPositionAt(displayTimeNs, newHandPosition);
 
     // Get keyboard movement
     QVector3D keyboardMovement = m_keyboardHandler->getMovementDirection();
 
-    // Only update camera position if there's a significant change and if the camera has a valid detection
-    const float MOVEMENT_THRESHOLD = 0.01f;
-    bool validPosition = (m_cameraHandler->getTrackedHandPosition() != QPoint(0, 0));
-    bool cameraChanged = validPosition && ((newHandPosition - m_handPosition).length() > MOVEMENT_THRESHOLD);
+    // Follow the camera only when the interpolated position moved noticeably, so a still or lost hand
+    // does not pull the sword back. The keyboard keeps the sword for a while after its keys are released.
+    if (m_keyboardHandler->isMoving())
+    {
+        m_keyboardTimer.start();
+    }
+    bool keyboardPriority = m_keyboardTimer.isValid() && m_keyboardTimer.elapsed() < KEYBOARD_PRIORITY_MS;
+    bool cameraChanged = validPosition && !keyboardPriority &&
+                         (newHandPosition - m_handPosition).length() > MOVEMENT_THRESHOLD;
 
     // Track what changed
     bool positionChanged = false;
@@ -85,7 +124,7 @@ void Game::updatePlayerPosition()
     else if (cameraChanged)
     {
         // Only update player position with camera if no keyboard input
-        // Apply smoothing/constraints to prevent extreme movements
+        // Smoothing is done by the hand sample history, only constrain extreme positions
         m_playerPosition.setX(qBound(-0.8f, m_handPosition.x(), 0.8f));
         m_playerPosition.setY(qBound(-0.8f, m_handPosition.y(), 0.8f));
     }
@@ -93,10 +132,74 @@ void Game::updatePlayerPosition()
     // Only emit position changed signal if position actually changed
     if (positionChanged)
     {
+        LatencyProbe::instance().mark(LatencyProbe::PositionSignal, m_lastSampleSequence);
 
         // Update the player's position on the grid through signal
         emit playerPositionChanged(m_playerPosition.x(), m_playerPosition.y());
     }
+
+    if (isTwoSwordsEnabled())
+    {
+        updateSecondPlayerPosition(displayTimeNs);
+    }
+}
+
+qint64 Game::predictionLeadNs() const
+{
+    // Measured camera interval (30 Hz until two samples arrived) and refresh interval of the primary screen
+    QScreen *screen = QGuiApplication::primaryScreen();
+    double refreshRate = screen ? screen->refreshRate() : 0.0;
+    double cameraIntervalNs = m_cameraIntervalNs > 0.0 ? m_cameraIntervalNs : 1.0e9 / 30.0;
+    double refreshIntervalNs = 1.0e9 / (refreshRate > 0.0 ? refreshRate : 60.0);
+    return static_cast<qint64>(cameraIntervalNs + refreshIntervalNs);
+}
+
+void Game::updateSecondPlayerPosition(qint64 displayTimeNs)
+{
+    // The second hand comes from the same camera frames, the keyboard only drives the first sword.
+    // The sample itself is not used: reading it adds it to the history queried below.
+    m_cameraHandler->latestHandSample(1);
+
+    QVector3D handPosition;
+    if (!m_cameraHandler->handPositionAt(displayTimeNs, handPosition, 1))
+    {
+        return;
+    }
+
+    // Only emit the signal if the position actually changed
+    QVector3D newPosition(qBound(-0.8f, handPosition.x(), 0.8f), qBound(-0.8f, handPosition.y(), 0.8f), 0.0f);
+    if (newPosition == m_secondPlayerPosition)
+    {
+        return;
+    }
+    m_secondPlayerPosition = newPosition;
+    emit secondPlayerPositionChanged(m_secondPlayerPosition.x(), m_secondPlayerPosition.y());
+}
+
+void Game::updateBladeTips()
+{
+    m_swordCount = 0;
+    if (m_player)
+    {
+        m_bladeTips[m_swordCount++] = m_player->getBladeTipPosition();
+    }
+    if (isTwoSwordsEnabled())
+    {
+        m_bladeTips[m_swordCount++] = m_secondPlayer->getBladeTipPosition();
+    }
+}
+
+void Game::setSecondPlayer(Player *player)
+{
+    m_secondPlayer = player;
+    updateBladeTips();
+}
+
+void Game::setTwoSwordsEnabled(bool enabled)
+{
+    m_twoSwords = enabled;
+    updateBladeTips();
+    qDebug() << "Two-sword mode:" << (enabled ? "on" : "off");
 }
 
 void Game::resetGame()
@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QVector3D>
 #include "player.h"
 #include "cameraHandler.h"
@@ -100,6 +101,36 @@ public:
      */
     Player *getPlayer() const { return m_player; }
 
+    /**
+     * @brief Sets the second player's sword used in two-sword mode
+     * @param player Pointer to the second sword (not owned)
+     */
+    void setSecondPlayer(Player *player);
+
+    /**
+     * @brief Enables or disables the second sword
+     * @param enabled true to move the second sword with the second tracked hand
+     */
+    void setTwoSwordsEnabled(bool enabled);
+
+    /**
+     * @brief Check if the second sword is in play
+     * @return true in two-sword mode
+     */
+    bool isTwoSwordsEnabled() const { return m_twoSwords && m_secondPlayer; }
+
+    /**
+     * @brief Get the number of swords in play
+     * @return 1, or 2 in two-sword mode
+     */
+    int swordCount() const { return m_swordCount; }
+
+    /**
+     * @brief Get the blade tip positions of the swords in play
+     * @return swordCount() world positions, refreshed once per update
+     */
+    const QVector3D *bladeTips() const { return m_bladeTips; }
+
     /**
      * @brief Check if the game is currently running
      * @return true if game is active, false otherwise
@@ -140,6 +171,13 @@ signals:
      */
     void playerPositionChanged(float gridX, float gridZ);
 
+    /**
+     * @brief Signal emitted when the second sword's position should change (two-sword mode)
+     * @param gridX X-coordinate on the grid (-1 to 1)
+     * @param gridZ Z-coordinate on the grid (-1 to 1)
+     */
+    void secondPlayerPositionChanged(float gridX, float gridZ);
+
 private slots:
     /**
      * @brief Decrements the countdown timer and starts game when countdown reaches zero
@@ -158,8 +196,29 @@ private:
      */
     void updatePlayerPosition();
 
+    /**
+     * @brief Update the second sword from the second tracked hand
+     * @param displayTimeNs Time the rendered frame is expected on screen (visionClockNs())
+     */
+    void updateSecondPlayerPosition(qint64 displayTimeNs);
+
+    /**
+     * @brief Get the extra prediction for the latency the vision timestamps cannot see
+     * @return Lead added to the current time when the hand position is queried (nanoseconds)
+     *
+     * Exposure and transfer take about one camera frame, measured from the sample timestamps,
+     * before the frame is read, and a swapped frame reaches the screen on the next display refresh.
+     */
+    qint64 predictionLeadNs() const;
+
+    /**
+     * @brief Caches the blade tips of the swords for the collision pass of the projectiles
+     */
+    void updateBladeTips();
+
     // Game components
     Player *m_player; // Pointer to the player's sword object
+    Player *m_secondPlayer; // Pointer to the second sword (two-sword mode), nullptr if none
     CameraHandler *m_cameraHandler; // Pointer to the camera handler
     KeyboardHandler *m_keyboardHandler; // Pointer to the keyboard handler
     ProjectileManager *m_projectileManager; // Pointer to the projectile manager
@@ -169,14 +228,31 @@ private:
     int m_lives; // Current lives
     bool m_gameStarted; // Flag to indicate if the game is active
     QVector3D m_handPosition; // Hand position from camera tracking
+    quint64 m_lastSampleSequence; // Sequence of the last camera sample consumed
+    qint64 m_lastSampleTimeNs; // Capture time of the last camera sample consumed (0 if none)
+    double m_cameraIntervalNs; // Smoothed interval between two camera frames (0 until measured)
+    QElapsedTimer m_keyboardTimer; // Time since a movement key was last held (invalid if never)
     QVector3D m_playerPosition; // Player position on the grid
+    QVector3D m_secondPlayerPosition; // Second sword position on the grid
     int m_pointsCounter; // Counter for consecutive hits
     bool m_standardMode; // true = standard mode, false = original mode
+    bool m_twoSwords; // Flag indicating if the second sword is in play
+
+    static const int MAX_SWORDS = 2; // Largest number of swords in play
+    QVector3D m_bladeTips[MAX_SWORDS]; // Blade tips of the swords, refreshed once per update
+    int m_swordCount; // Number of valid entries in m_bladeTips
 
     // Default values for different game modes
     static const int ORIGINAL_MODE_LIVES = 5; // Original mode lives
     static const int STANDARD_MODE_LIVES = 1; // Standard mode lives
 
+    // Camera moves smaller than this are ignored (grid units)
+    static constexpr float MOVEMENT_THRESHOLD = 0.01f;
+    // Time the keyboard keeps the sword after the keys are released, before the camera takes over again
+    static const int KEYBOARD_PRIORITY_MS = 500;
+    // Weight of a new measure in the smoothed camera interval
+    static constexpr double INTERVAL_SMOOTHING = 0.1;
+
     // Countdown state
     int m_countdownValue; // Countdown value
     QTimer *m_countdownTimer; // Timer for countdown
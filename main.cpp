@@ -1,4 +1,5 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include <ctime>
 #include "mainwindow.h"
 
@@ -10,10 +11,24 @@ int main(int argc, char *argv[])
     // Creating the QT application
     QApplication app(argc, argv);
 
+    // Command line options
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption measureLatencyOption("measure-latency",
+                                            "Measure the motion-to-photon latency on a synthetic hand motion, print it and quit.",
+                                            "seconds", "20");
+    parser.addOption(measureLatencyOption);
+    parser.process(app);
+
     // Creating the main window
     MainWindow mainWindow;
     mainWindow.show();
 
+    if (parser.isSet(measureLatencyOption))
+    {
+        mainWindow.startLatencyMeasurement(qMax(1, parser.value(measureLatencyOption).toInt()));
+    }
+
     // Executing the QT application
     return app.exec();
 }
@@ -4,6 +4,10 @@
 #include <QDebug>
 #include <QTimer>
 #include <QTime>
+#include <QApplication>
+#include <iostream>
+#include "vision/latencyProbe.h"
+#include "vision/syntheticFrameSource.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
@@ -73,6 +77,14 @@ MainWindow::MainWindow(QWidget *parent)
         // Connect player position changes to the GL widget
         connect(game, &Game::playerPositionChanged, glWidget, &MyGLWidget::positionPlayerOnGrid);
 
+        // Second sword, moved by a second hand when the camera panel enables two-hands tracking
+        game->setSecondPlayer(glWidget->getSecondPlayer());
+        connect(game, &Game::secondPlayerPositionChanged, glWidget, &MyGLWidget::positionSecondPlayerOnGrid);
+        connect(cameraHandler, &CameraHandler::twoHandsChanged, this, [this, glWidget](bool enabled)
+                {
+            game->setTwoSwordsEnabled(enabled);
+            glWidget->setSecondPlayerVisible(enabled); });
+
         // Connect keyboard speed changes
         connect(glWidget->getKeyboardHandler(), &KeyboardHandler::speedMultiplierChanged,
                 this, &MainWindow::updateSpeedIndicator);
@@ -83,6 +95,12 @@ MainWindow::MainWindow(QWidget *parent)
             if (game) {
                 game->update();
             } });
+
+        // Draw the camera preview inside the game view instead of rescaling it in the side panel
+        glWidget->setCameraFrameFunction([this]()
+                                         { return cameraHandler->acquireLatestFrame(); });
+        cameraHandler->setFramePreviewEnabled(true);
+        cameraHandler->setImagePreviewEnabled(false);
     }
 
     updateScoreDisplay();
@@ -419,6 +437,33 @@ void MainWindow::toggleGameMode()
     showStatusMessage(message, true);
 }
 
+void MainWindow::startLatencyMeasurement(int seconds)
+{
+    if (!cameraHandler)
+    {
+        return;
+    }
+
+    // The synthetic blob is plain skin colour, only the skin detector can follow it
+    VisionSettings settings = cameraHandler->visionSettings();
+    settings.detectorBackend = VisionSettings::SkinColorDetector;
+    cameraHandler->setVisionSettings(settings);
+
+    LatencyProbe::instance().setEnabled(true);
+    if (!cameraHandler->openSource(new SyntheticFrameSource()))
+    {
+        std::cerr << "Error opening the synthetic frame source" << std::endl;
+        return;
+    }
+    showStatusMessage(QString("Measuring latency for %1 s...").arg(seconds), true);
+
+    QTimer::singleShot(seconds * 1000, this, []()
+                       {
+        LatencyProbe::instance().setEnabled(false);
+        std::cout << LatencyProbe::instance().report().toStdString() << std::endl;
+        qApp->quit(); });
+}
+
 /**
  * @brief Toggles between internal (0) and external (1) camera sources
  *
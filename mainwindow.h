@@ -43,6 +43,16 @@ public:
      */
     bool isStandardMode() const { return m_standardMode; }
 
+    /**
+     * @brief Runs the motion-to-photon latency measurement
+     * @param seconds Duration of the measurement
+     *
+     * Replaces the camera by a scripted synthetic hand motion found by the skin colour
+     * detector, timestamps every hop up to the frame swap, then prints the per-hop
+     * distribution on the standard output and quits the application.
+     */
+    void startLatencyMeasurement(int seconds);
+
 private slots:
     /**
      * @brief Starts a new game and resets the score
@@ -9,6 +9,16 @@
 #include "corridor.h"
 #include "player.h"
 #include <QKeyEvent>
+#include "opencv2/core.hpp"
+#include "vision/latencyProbe.h"
+
+// GL_BGR and GL_CLAMP_TO_EDGE are core since OpenGL 1.2 but missing from the OpenGL 1.1 headers shipped on Windows
+#ifndef GL_BGR
+#define GL_BGR 0x80E0
+#endif
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
 
 MyGLWidget::MyGLWidget(QWidget *parent) : QOpenGLWidget(parent)
 {
@@ -24,6 +34,10 @@ MyGLWidget::MyGLWidget(QWidget *parent) : QOpenGLWidget(parent)
     // Using (0.0, 0.0) which places it in the center of the grid
     positionPlayerOnGrid(0.0, 0.0);
 
+    // The second sword has a pink blade and starts to the right of the first one
+    m_secondPlayer.setBladeColor(QColor(230, 140, 140));
+    positionSecondPlayerOnGrid(0.5, 0.0);
+
     // Set focus policy to explicitly capture keyboard input
     setFocusPolicy(Qt::StrongFocus);
 
@@ -32,11 +46,21 @@ MyGLWidget::MyGLWidget(QWidget *parent) : QOpenGLWidget(parent)
 
     // Do not initialize m_corridor here (OpenGL not ready)
     m_corridor = nullptr;
+
+    // Last hop of the motion-to-photon latency measurement
+    connect(this, &QOpenGLWidget::frameSwapped, this, []()
+            { LatencyProbe::instance().markLatest(LatencyProbe::FrameSwapped); });
 }
 
 MyGLWidget::~MyGLWidget()
 {
     // Clean up resources
+    if (m_cameraTexture)
+    {
+        makeCurrent();
+        glDeleteTextures(1, &m_cameraTexture);
+        doneCurrent();
+    }
     delete timer;
     if (m_corridor) delete m_corridor;
 }
@@ -150,6 +174,106 @@ void MyGLWidget::paintGL()
     // The positioning is handled by the positionPlayerOnGrid method,
     // which ensures the sword is properly aligned with the grid
     m_player.draw();
+    if (m_secondPlayerVisible)
+    {
+        m_secondPlayer.draw();
+    }
+
+    // Upload the newest camera frame, if any, and draw the preview over the scene
+    if (m_cameraFrameFunc)
+    {
+        const cv::Mat *frame = m_cameraFrameFunc();
+        if (frame)
+        {
+            uploadCameraFrame(*frame);
+        }
+    }
+    drawCameraPreview();
+}
+
+void MyGLWidget::uploadCameraFrame(const cv::Mat &frame)
+{
+    if (frame.empty() || frame.type() != CV_8UC3)
+    {
+        return;
+    }
+
+    if (!m_cameraTexture)
+    {
+        glGenTextures(1, &m_cameraTexture);
+        glBindTexture(GL_TEXTURE_2D, m_cameraTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    glBindTexture(GL_TEXTURE_2D, m_cameraTexture);
+
+    // Rows of a cv::Mat are not padded to 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(frame.step / frame.elemSize()));
+
+    // Storage is allocated once per frame size, following frames only update the texels
+    if (frame.cols != m_cameraTextureWidth || frame.rows != m_cameraTextureHeight)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, frame.cols, frame.rows, 0, GL_BGR, GL_UNSIGNED_BYTE, frame.data);
+        m_cameraTextureWidth = frame.cols;
+        m_cameraTextureHeight = frame.rows;
+    }
+    else
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, frame.cols, frame.rows, GL_BGR, GL_UNSIGNED_BYTE, frame.data);
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void MyGLWidget::drawCameraPreview()
+{
+    if (!m_cameraTexture || m_cameraTextureWidth <= 0 || m_cameraTextureHeight <= 0)
+    {
+        return;
+    }
+
+    // Quad in the bottom-right corner, in widget pixels, keeping the aspect ratio of the camera
+    const float margin = 10.0f;
+    float quadWidth = width() * cameraPreviewScale;
+    float quadHeight = quadWidth * m_cameraTextureHeight / m_cameraTextureWidth;
+    float left = width() - margin - quadWidth;
+    float bottom = margin;
+
+    glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_TEXTURE_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_LIGHTING);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, m_cameraTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0.0, width(), 0.0, height(), -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    // The first row of the frame is the top of the image
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 1.0f); glVertex2f(left, bottom);
+    glTexCoord2f(1.0f, 1.0f); glVertex2f(left + quadWidth, bottom);
+    glTexCoord2f(1.0f, 0.0f); glVertex2f(left + quadWidth, bottom + quadHeight);
+    glTexCoord2f(0.0f, 0.0f); glVertex2f(left, bottom + quadHeight);
+    glEnd();
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPopAttrib();
 }
 
 void MyGLWidget::drawCannon()
@@ -258,27 +382,30 @@ void MyGLWidget::drawAxes()
     glEnable(GL_LIGHTING);
 }
 
-// --- Smoothing state for sword position (Exponential Moving Average) ---
-static float smoothedGridX = 0.0f;
-static float smoothedGridY = 0.0f;
-static const float SMOOTHING_ALPHA = 0.35f; // Smoothing factor (0: no smoothing, 1: no lag)
-
 void MyGLWidget::positionPlayerOnGrid(float gridX, float gridY)
 {
-    // Exponential Moving Average (EMA) smoothing for sword movement
-    // This algorithm provides a smooth, low-latency interpolation between the previous and current hand positions.
-    // https://en.wikipedia.org/wiki/Exponential_smoothing
-    smoothedGridX = SMOOTHING_ALPHA * gridX + (1.0f - SMOOTHING_ALPHA) * smoothedGridX;
-    smoothedGridY = SMOOTHING_ALPHA * gridY + (1.0f - SMOOTHING_ALPHA) * smoothedGridY;
+    LatencyProbe::instance().markLatest(LatencyProbe::PositionApplied);
+    placeSwordOnGrid(m_player, gridX, gridY);
+}
+
+void MyGLWidget::positionSecondPlayerOnGrid(float gridX, float gridY)
+{
+    placeSwordOnGrid(m_secondPlayer, gridX, gridY);
+}
+
+void MyGLWidget::placeSwordOnGrid(Player &player, float gridX, float gridY)
+{
+    // Smoothing and latency compensation of the hand position are done upstream by the
+    // hand sample history, so the sword is placed exactly where it is asked to be
 
-    // Calculate the angle based on the smoothed gridX coordinate and gridAngle
-    float angle = (smoothedGridX * (gridAngle / 2.0f)) * M_PI / 180.0f;
+    // Calculate the angle based on the gridX coordinate and gridAngle
+    float angle = (gridX * (gridAngle / 2.0f)) * M_PI / 180.0f;
 
     // Get the base Y-coordinate of the grid (height)
     float baseY = 2.0f;
 
-    // Calculate the height offset based on smoothed gridY
-    float heightOffset = smoothedGridY * (corridorHeight * 0.25f);
+    // Calculate the height offset based on gridY
+    float heightOffset = gridY * (corridorHeight * 0.25f);
     float worldY = baseY + heightOffset;
 
     // Use a fixed radius for the grid cylinder
@@ -288,11 +415,11 @@ void MyGLWidget::positionPlayerOnGrid(float gridX, float gridY)
     float worldZ = -radius * std::cos(angle); // Negative for OpenGL z-axis orientation
 
     // Set the player's position directly on the grid surface
-    m_player.setPosition(QVector3D(worldX, worldY, worldZ));
+    player.setPosition(QVector3D(worldX, worldY, worldZ));
 
     // Set the player's rotation to face perpendicular to the grid surface
     float rotationY = angle * 180.0f / M_PI;
-    m_player.setRotation(0.0f, rotationY, 0.0f);
+    player.setRotation(0.0f, rotationY, 0.0f);
 }
 
 void MyGLWidget::keyPressEvent(QKeyEvent *event)
@@ -13,6 +13,11 @@
 #include "corridor.h"
 #include "keyboardhandler.h"
 
+namespace cv
+{
+    class Mat;
+}
+
 /**
  * @class MyGLWidget
  * @brief Main OpenGL widget for 3D rendering of the Slice Defender game.
@@ -45,6 +50,18 @@ public:
      */
     Player *getPlayer() { return &m_player; }
 
+    /**
+     * @brief Returns a pointer to the second player's sword (two-sword mode)
+     * @return Pointer to the second Player instance
+     */
+    Player *getSecondPlayer() { return &m_secondPlayer; }
+
+    /**
+     * @brief Shows or hides the second sword
+     * @param visible true in two-sword mode
+     */
+    void setSecondPlayerVisible(bool visible) { m_secondPlayerVisible = visible; }
+
     /**
      * @brief Returns a pointer to the projectile manager
      * @return Pointer to the ProjectileManager instance
@@ -68,6 +85,18 @@ public:
         m_gameUpdateFunc = updateFunc;
     }
 
+    /**
+     * @brief Sets the function providing the camera preview frames
+     * @param frameFunc Function returning the latest BGR camera frame if it changed, nullptr otherwise
+     *
+     * New frames are uploaded to a streaming texture and drawn as a picture-in-picture
+     * quad in the bottom-right corner; scaling and BGR swizzling happen during texture sampling.
+     */
+    void setCameraFrameFunction(std::function<const cv::Mat *()> frameFunc)
+    {
+        m_cameraFrameFunc = frameFunc;
+    }
+
     /**
      * @brief Positions the player's sword on the cylindrical grid from grid coordinates
      *
@@ -79,6 +108,15 @@ public:
      */
     void positionPlayerOnGrid(float gridX = 0.0f, float gridY = 0.0f);
 
+    /**
+     * @brief Positions the second sword on the cylindrical grid from grid coordinates
+     * @param gridX X coordinate on the grid (from -1.0 to 1.0)
+     * @param gridY Y coordinate on the grid (from -1.0 to 1.0)
+     *
+     * Connected to the secondPlayerPositionChanged signal of the Game class.
+     */
+    void positionSecondPlayerOnGrid(float gridX = 0.0f, float gridY = 0.0f);
+
 protected:
     // QOpenGLWidget methods to override
     /**
@@ -125,6 +163,22 @@ private:
      * @brief Draws a test object (for debugging).
      */
     void drawTestObject();
+    /**
+     * @brief Uploads a camera frame to the preview texture.
+     * @param frame BGR camera frame
+     */
+    void uploadCameraFrame(const cv::Mat &frame);
+    /**
+     * @brief Draws the camera preview texture as a picture-in-picture quad.
+     */
+    void drawCameraPreview();
+    /**
+     * @brief Places a sword on the cylindrical grid surface.
+     * @param player Sword to place
+     * @param gridX X coordinate on the grid (from -1.0 to 1.0)
+     * @param gridY Y coordinate on the grid (from -1.0 to 1.0)
+     */
+    void placeSwordOnGrid(Player &player, float gridX, float gridY);
 
     QTimer *timer; // Timer for periodic updates
 
@@ -139,10 +193,18 @@ private:
 
     ProjectileManager m_projectileManager; // Manages all projectiles in the game
     Player m_player; // Represents the player's sword
+    Player m_secondPlayer; // Second sword of the two-sword mode
+    bool m_secondPlayerVisible = false; // Flag indicating if the second sword is drawn
     Corridor* m_corridor; // Pointer to the corridor object
     KeyboardHandler m_keyboardHandler; // Handles keyboard input
     QTime m_lastFrameTime; // Tracks the last frame time
     std::function<void()> m_gameUpdateFunc = nullptr; // Game update function
+    std::function<const cv::Mat *()> m_cameraFrameFunc = nullptr; // Camera preview frame provider
+
+    GLuint m_cameraTexture = 0; // Streaming texture of the camera preview (0 until the first frame)
+    int m_cameraTextureWidth = 0; // Width of the camera texture storage
+    int m_cameraTextureHeight = 0; // Height of the camera texture storage
+    const float cameraPreviewScale = 0.25f; // Width of the camera preview relative to the widget
 };
 
 #endif // MYGLWIDGET_H
@@ -47,6 +47,11 @@ QVector3D Player::getRotation() const
     return m_rotation;
 }
 
+void Player::setBladeColor(const QColor &color)
+{
+    m_bladeColor = color;
+}
+
 void Player::draw() const
 {
     glPushMatrix();
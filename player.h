@@ -64,6 +64,12 @@ public:
      */
     QVector3D getBladeTipPosition() const;
 
+    /**
+     * @brief Sets the color of the blade
+     * @param color New blade color, used to tell the two swords apart
+     */
+    void setBladeColor(const QColor &color);
+
     /**
      * @brief Draws the sword with all its components
      */
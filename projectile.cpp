@@ -90,29 +90,11 @@ void Projectile::update(float deltaTime)
             return;
         }
 
-        // Check for collision with player's sword
-        if (m_game->getPlayer())
-        {
-            checkCollisionWithPlayer(m_game->getPlayer());
-        }
+        // Check for collision with the players' swords
+        checkCollisionWithPlayers(m_game->bladeTips(), m_game->swordCount());
     }
 }
 
-bool Projectile::isNearPlayer(const Player &player) const
-{
-    // Get player's blade position for more accurate collision detection
-    QVector3D swordBladePos = player.getBladeTipPosition();
-
-    // Get projectile position
-    QVector3D projectilePos(m_position[0], m_position[1], m_position[2]);
-
-    // Calculate distance between projectile and sword blade
-    float distance = (projectilePos - swordBladePos).length();
-
-    // Check if within collision threshold (player's sword + projectile radius)
-    return (distance < COLLISION_THRESHOLD + getRadius());
-}
-
 bool Projectile::isInGridZone(float gridZPosition, float gridYPosition, float gridThickness) const
 {
     // Check if projectile is in the cylindrical grid zone
@@ -133,16 +115,26 @@ bool Projectile::hasTouchedFloor() const
     return m_position[1] <= 0.0f;
 }
 
-void Projectile::checkCollisionWithPlayer(Player *player)
+void Projectile::checkCollisionWithPlayers(const QVector3D *bladeTips, int swordCount)
 {
-    // Skip if already sliced or player is null
-    if (m_sliced || !player)
+    // Skip if already sliced or there is no sword
+    if (m_sliced || !bladeTips || swordCount <= 0)
     {
         return;
     }
 
-    // Check if the projectile is near the player's sword
-    if (isNearPlayer(*player))
+    // Within the collision threshold (sword + projectile radius) of a blade tip, on squared distances
+    QVector3D projectilePos(m_position[0], m_position[1], m_position[2]);
+    float threshold = COLLISION_THRESHOLD + getRadius();
+    float thresholdSquared = threshold * threshold;
+    bool touched = false;
+    for (int i = 0; i < swordCount && !touched; i++)
+    {
+        touched = (projectilePos - bladeTips[i]).lengthSquared() < thresholdSquared;
+    }
+
+    // Check if the projectile is near one of the swords
+    if (touched)
     {
         // Mark the projectile for slicing
         m_shouldSlice = true;
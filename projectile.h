@@ -71,12 +71,6 @@ public:
     virtual float getRadius() const = 0;
 
     // Collision detection methods
-    /**
-     * @brief Checks if the projectile is near the player.
-     * @param player Reference to the player
-     * @return True if near the player
-     */
-    bool isNearPlayer(const Player &player) const;
     /**
      * @brief Checks if the projectile is in the grid zone.
      * @param gridZPosition Z position of the grid
@@ -98,10 +92,13 @@ public:
      */
     bool hasTouchedFloor() const;
     /**
-     * @brief Checks and handles collision with the player.
-     * @param player Pointer to the player
+     * @brief Checks and handles collision with the players' swords in one pass.
+     * @param bladeTips World positions of the blade tips, computed once per frame by the game
+     * @param swordCount Number of swords in play (1 or 2)
+     *
+     * A projectile touched by both swords is sliced and scored only once.
      */
-    void checkCollisionWithPlayer(Player *player);
+    void checkCollisionWithPlayers(const QVector3D *bladeTips, int swordCount);
 
     // Getters
     /**
@@ -1,5 +1,5 @@
 # configuration Qt
-QT       += core gui
+QT       += core gui concurrent
 
 equals(QT_MAJOR_VERSION, 5) {
         QT += opengl widgets
@@ -81,9 +81,8 @@ DISTFILES += \
     res/orange_normal.png \
     res/wall.png
 
-INCLUDEPATH +=$$(OPENCV_DIR)\..\..\include
-
-LIBS += -L$$(OPENCV_DIR)\lib -lopencv_core4110 -lopencv_highgui4110 -lopencv_imgproc4110 -lopencv_imgcodecs4110 -lopencv_videoio4110 -lopencv_features2d4110 -lopencv_calib3d4110 -lopencv_objdetect4110
+# vision pipeline and OpenCV, shared with the slice-vision-bench tool
+include(vision/vision.pri)
 
 FORMS += \
     camerahandler.ui \
@@ -0,0 +1,86 @@
+#include "detectionScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+DetectionScheduler::DetectionScheduler()
+    : m_frameRate(30.0)
+{
+    applySettings(VisionSettings());
+    reset(m_frameRate);
+}
+
+void DetectionScheduler::applySettings(const VisionSettings &settings)
+{
+    m_adaptive = settings.adaptiveRedetect;
+    m_initialInterval = std::max(0, settings.redetectInterval);
+    m_maxInterval = std::max(m_initialInterval, settings.maxRedetectInterval);
+    m_qualityThreshold = settings.redetectQuality;
+    m_budgetSetting = settings.frameBudgetMs;
+}
+
+void DetectionScheduler::reset(double frameRate)
+{
+    m_frameRate = frameRate > 0.0 ? frameRate : 30.0;
+    m_interval = m_initialInterval;
+    m_flowFrames = 0;
+    m_poorMatch = false;
+    m_detectionMs = 0.0;
+    m_trackingMs = 0.0;
+}
+
+void DetectionScheduler::recordDetection(int matchQuality, double ms)
+{
+    m_detectionMs = m_detectionMs > 0.0 ? m_detectionMs + COST_SMOOTHING * (ms - m_detectionMs) : ms;
+
+    // Additive increase while the matches are good and the flow holds until the detection is due
+    m_poorMatch = matchQuality < m_qualityThreshold;
+    if (!m_poorMatch && m_flowFrames >= m_interval)
+    {
+        m_interval = std::min(m_maxInterval, m_interval + 1);
+    }
+    m_flowFrames = 0;
+}
+
+void DetectionScheduler::recordTrackedFrame(double ms)
+{
+    m_trackingMs = m_trackingMs > 0.0 ? m_trackingMs + COST_SMOOTHING * (ms - m_trackingMs) : ms;
+    m_flowFrames++;
+}
+
+void DetectionScheduler::recordTrackingLost()
+{
+    // Multiplicative decrease, the next frame is detected anyway since the flow is lost
+    m_interval /= 2;
+}
+
+int DetectionScheduler::interval() const
+{
+    // A poor match is confirmed on the next frame whatever the budget, in both modes
+    if (m_poorMatch)
+    {
+        return 0;
+    }
+
+    if (!m_adaptive)
+    {
+        return m_initialInterval;
+    }
+    return std::min(m_maxInterval, std::max(m_interval, budgetInterval()));
+}
+
+int DetectionScheduler::budgetInterval() const
+{
+    // A configured budget replaces the frame interval of the source
+    double budgetMs = m_budgetSetting > 0.0 ? m_budgetSetting : 1000.0 / m_frameRate;
+    if (m_detectionMs <= budgetMs)
+    {
+        return 0;
+    }
+    if (m_trackingMs >= budgetMs)
+    {
+        return m_maxInterval;
+    }
+
+    // (detection + k * tracking) / (k + 1) <= budget
+    return static_cast<int>(std::ceil((m_detectionMs - budgetMs) / (budgetMs - m_trackingMs)));
+}
@@ -0,0 +1,92 @@
+#ifndef DETECTIONSCHEDULER_H
+#define DETECTIONSCHEDULER_H
+
+#include "visionSettings.h"
+
+/**
+ * @brief Decides on which frames the full detection runs while the hand is tracked
+ *
+ * Between two detections the hand is followed by the cheap optical flow. The number
+ * of flow frames allowed before the next detection adapts to the tracking quality:
+ * it grows by one after each good match whose flow run ended on schedule, is halved
+ * when the flow loses the hand, and drops to zero (detect on the next frame) when the
+ * match quality falls below VisionSettings::redetectQuality.
+ *
+ * The frame budget sets a lower bound: when a detection costs more than a frame
+ * interval, enough flow frames are interleaved for the average frame to fit the budget.
+ */
+class DetectionScheduler
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    DetectionScheduler();
+
+    /**
+     * @brief Applies the cadence settings
+     * @param settings Pipeline settings (adaptiveRedetect, redetectInterval, maxRedetectInterval,
+     *                 redetectQuality, frameBudgetMs)
+     */
+    void applySettings(const VisionSettings &settings);
+
+    /**
+     * @brief Restarts from the configured interval for a new stream
+     * @param frameRate Frame rate of the source, gives the budget when frameBudgetMs is 0
+     */
+    void reset(double frameRate);
+
+    /**
+     * @brief Check if the next frame must run the full detection
+     * @return true when the flow frames allowed since the last detection are used up
+     */
+    bool detectionDue() const { return m_flowFrames >= interval(); }
+
+    /**
+     * @brief Records a frame where the full detection and the feature match ran
+     * @param matchQuality Quality of the feature match (0-100)
+     * @param ms Time spent detecting and matching
+     */
+    void recordDetection(int matchQuality, double ms);
+
+    /**
+     * @brief Records a frame followed by the optical flow
+     * @param ms Time spent in the flow update
+     */
+    void recordTrackedFrame(double ms);
+
+    /**
+     * @brief Records that the optical flow lost the hand before the detection was due
+     */
+    void recordTrackingLost();
+
+    /**
+     * @brief Get the number of flow frames allowed between two detections
+     * @return Current interval, including the frame budget bound
+     */
+    int interval() const;
+
+private:
+    /**
+     * @brief Computes the flow frames needed for the average frame to fit the budget
+     * @return Minimum interval, 0 when a detection fits in a frame interval
+     */
+    int budgetInterval() const;
+
+    bool m_adaptive;         // Flag indicating if the interval adapts, fixed at redetectInterval otherwise
+    int m_initialInterval;   // Interval used after a reset
+    int m_maxInterval;       // Largest adaptive interval
+    int m_qualityThreshold;  // Match quality below which the next frame is detected again
+    double m_budgetSetting;  // Configured frame budget (ms), 0 = frame interval of the source
+    double m_frameRate;      // Frame rate of the source
+
+    int m_interval;          // Adaptive interval from the tracking quality
+    int m_flowFrames;        // Flow frames since the last detection
+    bool m_poorMatch;        // Flag indicating if the last match was below the quality threshold
+    double m_detectionMs;    // Smoothed cost of a detection frame
+    double m_trackingMs;     // Smoothed cost of a flow frame
+
+    static constexpr double COST_SMOOTHING = 0.2; // Weight of the last frame in the smoothed costs
+};
+
+#endif // DETECTIONSCHEDULER_H
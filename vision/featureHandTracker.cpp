@@ -0,0 +1,136 @@
+#include "featureHandTracker.h"
+#include <iostream>
+#include <QElapsedTimer>
+
+FeatureHandTracker::FeatureHandTracker(Backend backend, Ptr<Feature2D> features,
+                                       Ptr<DescriptorMatcher> matcher, float ratioThreshold)
+    : m_backend(backend),
+      m_features(features),
+      m_matcher(matcher),
+      m_ratioThreshold(ratioThreshold)
+{
+}
+
+bool FeatureHandTracker::setReference(const Mat &reference)
+{
+    m_referenceKeypoints.clear();
+    m_matcher->clear();
+
+    if (reference.empty())
+    {
+        return false;
+    }
+
+    try
+    {
+        // The reference does not change until the next capture, so its features are computed once here
+        Mat referenceDescriptors;
+        m_features->detectAndCompute(reference, noArray(), m_referenceKeypoints, referenceDescriptors);
+
+        // Not enough keypoints to match against, every frame will report a 0% match
+        if (referenceDescriptors.empty() || m_referenceKeypoints.size() < 4)
+        {
+            return false;
+        }
+
+        // Build the matcher index on the reference descriptors once, frames are then queried against it
+        m_matcher->add(std::vector<Mat>{referenceDescriptors});
+        m_matcher->train();
+        return true;
+    }
+    catch (const cv::Exception &e)
+    {
+        std::cerr << "OpenCV error in FeatureHandTracker::setReference: " << e.what() << std::endl;
+        m_referenceKeypoints.clear();
+        m_matcher->clear();
+        return false;
+    }
+}
+
+TrackResult FeatureHandTracker::trackRoi(const Mat &frame, const Rect &roi)
+{
+    // Tracked alone, the region is described again on every frame
+    m_roiFeatures.described = false;
+    return trackRoi(frame, roi, m_roiFeatures);
+}
+
+TrackResult FeatureHandTracker::trackRoi(const Mat &frame, const Rect &roi, RoiFeatures &features)
+{
+    TrackResult result;
+
+    // Fall back to the center of the region of interest
+    result.position = Point2f(roi.x + roi.width / 2.0f, roi.y + roi.height / 2.0f);
+
+    if (frame.empty() || roi.empty())
+    {
+        return result;
+    }
+
+    try
+    {
+        // Only the current region of interest is described, the reference index is reused.
+        // A region already described by another tracker of the backend is only matched.
+        std::vector<KeyPoint> &keypoints = features.keypoints;
+        QElapsedTimer stageTimer;
+        stageTimer.start();
+        if (!features.described)
+        {
+            m_features->detectAndCompute(frame(roi), noArray(), keypoints, features.descriptors);
+            features.described = true;
+            result.describeMs = stageTimer.nsecsElapsed() / 1.0e6;
+        }
+
+        // Keypoints are reported in frame coordinates and their mean is the tracked position
+        if (!keypoints.empty())
+        {
+            Point2f sum(0.0f, 0.0f);
+            for (const KeyPoint &kp : keypoints)
+            {
+                Point2f pt(roi.x + kp.pt.x, roi.y + kp.pt.y);
+                result.points.push_back(pt);
+                sum += pt;
+            }
+            result.position = sum * (1.0f / keypoints.size());
+        }
+        result.found = true;
+
+        // Check if descriptors are empty or not enough keypoints
+        if (m_matcher->empty() || features.descriptors.empty() || keypoints.size() < 4)
+        {
+            return result;
+        }
+
+        // Find the two nearest reference descriptors of each current descriptor
+        std::vector<std::vector<DMatch>> &knn_matches = m_knnMatches;
+        stageTimer.restart();
+        m_matcher->knnMatch(features.descriptors, knn_matches, 2);
+
+        // Apply ratio test to find good matches. Several region keypoints can match the same
+        // reference keypoint, each reference keypoint is only counted once.
+        m_matchedReference.assign(m_referenceKeypoints.size(), false);
+        int goodMatches = 0;
+        for (size_t i = 0; i < knn_matches.size(); i++)
+        {
+            if (knn_matches[i].size() > 1 &&
+                knn_matches[i][0].distance < m_ratioThreshold * knn_matches[i][1].distance &&
+                !m_matchedReference[knn_matches[i][0].trainIdx])
+            {
+                m_matchedReference[knn_matches[i][0].trainIdx] = true;
+                goodMatches++;
+            }
+        }
+
+        // Calculate match quality as the percentage (0-100) of the reference keypoints found in the region
+        result.matchQuality = static_cast<int>(goodMatches * 100.0 / std::max(1, static_cast<int>(m_referenceKeypoints.size())));
+        result.matchMs = stageTimer.nsecsElapsed() / 1.0e6;
+    }
+    catch (const cv::Exception &e)
+    {
+        std::cerr << "OpenCV error in FeatureHandTracker::trackRoi: " << e.what() << std::endl;
+        result.found = false;
+        result.matchQuality = 0;
+        result.points.clear();
+    }
+
+    return result;
+}
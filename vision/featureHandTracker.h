@@ -0,0 +1,47 @@
+#ifndef FEATUREHANDTRACKER_H
+#define FEATUREHANDTRACKER_H
+
+#include "handTracker.h"
+
+/**
+ * @brief Hand tracker based on keypoint descriptors
+ *
+ * The reference descriptors are computed once when the reference is set and the
+ * matcher is trained on them; each frame only describes the region of interest and
+ * queries it against the trained matcher with a ratio test. The region can also be described
+ * once and queried against the matchers of several trackers of the same backend.
+ * The same class implements the SIFT/FLANN and the binary descriptor/Hamming backends.
+ */
+class FeatureHandTracker : public HandTracker
+{
+public:
+    /**
+     * @brief Constructor
+     * @param backend Backend identifier reported by backend()
+     * @param features Keypoint detector and descriptor extractor
+     * @param matcher Descriptor matcher suited to the descriptor type
+     * @param ratioThreshold Lowe ratio test threshold
+     */
+    FeatureHandTracker(Backend backend, Ptr<Feature2D> features, Ptr<DescriptorMatcher> matcher,
+                       float ratioThreshold);
+
+    Backend backend() const override { return m_backend; }
+    bool setReference(const Mat &reference) override;
+
+protected:
+    TrackResult trackRoi(const Mat &frame, const Rect &roi) override;
+    TrackResult trackRoi(const Mat &frame, const Rect &roi, RoiFeatures &features) override;
+
+private:
+    Backend m_backend;                         // Backend identifier
+    Ptr<Feature2D> m_features;                 // Detector and descriptor extractor reused for every frame
+    Ptr<DescriptorMatcher> m_matcher;          // Matcher trained on the reference descriptors
+    float m_ratioThreshold;                    // Ratio threshold for matching
+    std::vector<KeyPoint> m_referenceKeypoints; // Keypoints of the reference image
+
+    RoiFeatures m_roiFeatures;                         // Features of the last region of interest tracked alone
+    std::vector<std::vector<DMatch>> m_knnMatches;     // Matches of the last region of interest
+    std::vector<bool> m_matchedReference;              // Reference keypoints already matched in the last region
+};
+
+#endif // FEATUREHANDTRACKER_H
@@ -0,0 +1,33 @@
+#include "frameOverlay.h"
+
+void FrameOverlay::clear()
+{
+    m_rects.clear();
+    m_points.clear();
+}
+
+void FrameOverlay::addRect(const Rect &rect, const Scalar &color, int thickness)
+{
+    m_rects.push_back({rect, color, thickness});
+}
+
+void FrameOverlay::addPoint(const Point2f &center, int radius, const Scalar &color)
+{
+    m_points.push_back({center, radius, color});
+}
+
+void FrameOverlay::draw(Mat &image, double scale) const
+{
+    for (const RectShape &shape : m_rects)
+    {
+        Rect scaled(cvRound(shape.rect.x * scale), cvRound(shape.rect.y * scale),
+                    cvRound(shape.rect.width * scale), cvRound(shape.rect.height * scale));
+        rectangle(image, scaled, shape.color, shape.thickness);
+    }
+
+    for (const PointShape &shape : m_points)
+    {
+        Point center(cvRound(shape.center.x * scale), cvRound(shape.center.y * scale));
+        circle(image, center, std::max(1, cvRound(shape.radius * scale)), shape.color, -1);
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef FRAMEOVERLAY_H
+#define FRAMEOVERLAY_H
+
+#include "opencv2/opencv.hpp"
+#include <vector>
+
+using namespace cv;
+
+/**
+ * @brief The FrameOverlay class records the annotations of a processed frame
+ *
+ * The pipeline no longer draws on a copy of the camera frame: it records rectangles
+ * and points here, and they are drawn once on the preview image, at preview resolution.
+ * clear() keeps the capacity of the lists so recording allocates nothing in steady state.
+ */
+class FrameOverlay
+{
+public:
+    /**
+     * @brief Removes all the annotations, keeping the allocated capacity
+     */
+    void clear();
+
+    /**
+     * @brief Records a rectangle outline
+     * @param rect Rectangle in frame coordinates
+     * @param color BGR color
+     * @param thickness Line thickness in preview pixels
+     */
+    void addRect(const Rect &rect, const Scalar &color, int thickness = 1);
+
+    /**
+     * @brief Records a filled disc
+     * @param center Center in frame coordinates
+     * @param radius Radius in frame pixels
+     * @param color BGR color
+     */
+    void addPoint(const Point2f &center, int radius, const Scalar &color);
+
+    /**
+     * @brief Draws the annotations on an image
+     * @param image Image to draw on, may be a scaled version of the frame
+     * @param scale Size of the image divided by the size of the frame
+     */
+    void draw(Mat &image, double scale = 1.0) const;
+
+private:
+    struct RectShape
+    {
+        Rect rect;
+        Scalar color;
+        int thickness;
+    };
+
+    struct PointShape
+    {
+        Point2f center;
+        int radius;
+        Scalar color;
+    };
+
+    std::vector<RectShape> m_rects;   // Rectangles, drawn first
+    std::vector<PointShape> m_points; // Discs, drawn over the rectangles
+};
+
+#endif // FRAMEOVERLAY_H
@@ -0,0 +1,69 @@
+#include "framePacket.h"
+
+void FramePacket::reset(const Mat &raw, quint64 index)
+{
+    // Mirror image for natural interaction, into the pooled frame buffer
+    flip(raw, m_bgr, 1);
+    m_index = index;
+    m_hasGray = false;
+    m_detectionScale = 0;
+}
+
+void FramePacket::clearPyramids()
+{
+    m_pyramid.frame = 0;
+    m_previousPyramid.frame = 0;
+}
+
+const Mat &FramePacket::gray()
+{
+    if (!m_hasGray)
+    {
+        cvtColor(m_bgr, m_gray, COLOR_BGR2GRAY);
+        m_hasGray = true;
+    }
+    return m_gray;
+}
+
+const FlowPyramid &FramePacket::pyramid()
+{
+    if (m_pyramid.frame != m_index)
+    {
+        // The current pyramid becomes the previous one, its buffers are reused for this frame
+        std::swap(m_pyramid, m_previousPyramid);
+        m_pyramid.build(gray(), m_index);
+    }
+    return m_pyramid;
+}
+
+void FramePacket::detectionImages(const Rect &window, int scale, Mat &equalized, Mat &inverted)
+{
+    if (m_detectionScale != scale || m_detectionWindow != window)
+    {
+        // The pools are sized for the whole frame once, the window is a view of them
+        m_detectionPool.create(m_bgr.rows / scale + 1, m_bgr.cols / scale + 1, CV_8UC1);
+        m_invertedPool.create(m_detectionPool.size(), CV_8UC1);
+        Size detectionSize(cvRound(window.width / double(scale)), cvRound(window.height / double(scale)));
+        m_equalized = m_detectionPool(Rect(Point(0, 0), detectionSize));
+        m_inverted = m_invertedPool(Rect(Point(0, 0), detectionSize));
+
+        // The window of the shared grayscale frame is downsampled (or equalized directly at full scale)
+        Mat windowGray = gray()(window);
+        if (scale > 1)
+        {
+            resize(windowGray, m_equalized, detectionSize, 0, 0, INTER_AREA);
+            equalizeHist(m_equalized, m_equalized); // Improve contrast for better detection
+        }
+        else
+        {
+            equalizeHist(windowGray, m_equalized);
+        }
+        bitwise_not(m_equalized, m_inverted); // Invert image for better palm detection
+
+        m_detectionWindow = window;
+        m_detectionScale = scale;
+    }
+
+    equalized = m_equalized;
+    inverted = m_inverted;
+}
@@ -0,0 +1,91 @@
+#ifndef FRAMEPACKET_H
+#define FRAMEPACKET_H
+
+#include "opencv2/opencv.hpp"
+#include <QtGlobal>
+#include "opticalFlowTracker.h"
+
+using namespace cv;
+
+/**
+ * @brief One camera frame and the images derived from it, shared by all the pipeline stages
+ *
+ * The frame is read once per tick and mirrored into the packet; the grayscale image,
+ * the flow pyramid and the equalized and inverted detection images are computed the
+ * first time a stage asks for them and reused by the following stages of the same
+ * frame. All the buffers are pooled and reused from one frame to the next.
+ */
+class FramePacket
+{
+public:
+    /**
+     * @brief Starts a new frame
+     * @param raw Frame read from the source, left untouched
+     * @param index Index of the frame, increasing with each processed frame
+     */
+    void reset(const Mat &raw, quint64 index);
+
+    /**
+     * @brief Forgets the pyramids of the previous frames, for a new stream
+     */
+    void clearPyramids();
+
+    /**
+     * @brief Get the mirrored frame
+     * @return BGR frame
+     */
+    const Mat &bgr() const { return m_bgr; }
+
+    /**
+     * @brief Get the index of the frame
+     * @return Index given to reset()
+     */
+    quint64 index() const { return m_index; }
+
+    /**
+     * @brief Get the grayscale frame, converted on the first call
+     * @return Full resolution grayscale frame
+     */
+    const Mat &gray();
+
+    /**
+     * @brief Get the flow pyramid of the frame, built on the first call
+     * @return Pyramid of the grayscale frame
+     *
+     * The pyramid of the last frame it was built for becomes previousPyramid().
+     */
+    const FlowPyramid &pyramid();
+
+    /**
+     * @brief Get the pyramid built before the one of this frame
+     * @return Pyramid of an earlier frame, check its index before use
+     */
+    const FlowPyramid &previousPyramid() const { return m_previousPyramid; }
+
+    /**
+     * @brief Get the images searched by the cascades, computed once per frame
+     * @param window Region of the frame to search
+     * @param scale Downsampling factor of the detection
+     * @param equalized Receives the downsampled and equalized grayscale window
+     * @param inverted Receives the inverted equalized window
+     */
+    void detectionImages(const Rect &window, int scale, Mat &equalized, Mat &inverted);
+
+private:
+    Mat m_bgr;             // Mirrored frame (pooled)
+    quint64 m_index = 0;   // Index of the frame
+    Mat m_gray;            // Grayscale frame (pooled)
+    bool m_hasGray = false; // Flag indicating if m_gray holds the current frame
+
+    FlowPyramid m_pyramid;         // Pyramid of the current frame, once built
+    FlowPyramid m_previousPyramid; // Pyramid built before
+
+    Mat m_detectionPool;   // Downsampled and equalized search window, sized for the whole frame
+    Mat m_invertedPool;    // Inverted detection image, sized for the whole frame
+    Mat m_equalized;       // View of m_detectionPool holding the current window
+    Mat m_inverted;        // View of m_invertedPool holding the current window
+    Rect m_detectionWindow; // Window of the current detection images
+    int m_detectionScale = 0; // Scale of the current detection images (0 = not computed)
+};
+
+#endif // FRAMEPACKET_H
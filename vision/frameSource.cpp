@@ -0,0 +1,238 @@
+#include "frameSource.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <algorithm>
+#include "visionClock.h"
+
+using namespace cv;
+
+FrameSource::FrameSource(Pacing pacing)
+    : m_pacing(pacing),
+      m_framesDelivered(0),
+      m_readTimeNs(0)
+{
+}
+
+void FrameSource::setPacing(Pacing pacing)
+{
+    m_pacing = pacing;
+    m_replayClock.invalidate();
+}
+
+bool FrameSource::read(Mat &frame)
+{
+    if (!readFrame(frame) || frame.empty())
+    {
+        return false;
+    }
+
+    // A camera is paced by the device and nothing waits in AsFastAsPossible mode
+    if (isLive() || m_pacing == AsFastAsPossible)
+    {
+        m_readTimeNs = visionClockNs();
+        return true;
+    }
+
+    // The first frame starts the replay clock, the next ones wait for their due time.
+    // A late frame is delivered immediately: recorded frames are never skipped.
+    if (!m_replayClock.isValid())
+    {
+        m_replayClock.start();
+        m_framesDelivered = 0;
+    }
+    else
+    {
+        double rate = frameRate() > 0.0 ? frameRate() : 30.0;
+        qint64 dueUs = static_cast<qint64>(m_framesDelivered * 1000000.0 / rate);
+        qint64 waitUs = dueUs - m_replayClock.nsecsElapsed() / 1000;
+        if (waitUs > 0)
+        {
+            QThread::usleep(static_cast<unsigned long>(waitUs));
+        }
+    }
+    ++m_framesDelivered;
+    m_readTimeNs = visionClockNs();
+
+    return true;
+}
+
+FrameSource *FrameSource::createFromPath(const QString &path, Pacing pacing)
+{
+    FrameSource *source = nullptr;
+    if (QFileInfo(path).isDir())
+    {
+        source = new ImageSequenceFrameSource(path, 30.0, pacing);
+    }
+    else
+    {
+        source = new VideoFileFrameSource(path, pacing);
+    }
+
+    if (!source->isOpened())
+    {
+        delete source;
+        return nullptr;
+    }
+    return source;
+}
+
+CameraFrameSource::CameraFrameSource(int cameraIndex, CaptureMode mode)
+    : FrameSource(RealTime),
+      m_cameraIndex(cameraIndex),
+      m_captureMode(Sequential),
+      m_frameIntervalNs(0.0),
+      m_grabTimeNs(0),
+      m_droppedFrames(0),
+      m_lateFrames(0)
+{
+    m_capture.open(cameraIndex);
+    m_frameIntervalNs = 1.0e9 / frameRate();
+    setCaptureMode(mode);
+}
+
+void CameraFrameSource::setCaptureMode(CaptureMode mode)
+{
+    m_captureMode = mode;
+
+    // A single driver buffer keeps the queue short where the backend supports it,
+    // the drain in readFrame() covers the backends that ignore the property
+    if (m_capture.isOpened() && mode == Freshest)
+    {
+        m_capture.set(CAP_PROP_BUFFERSIZE, 1);
+    }
+}
+
+bool CameraFrameSource::readFrame(Mat &frame)
+{
+    // Frames the driver captured since the previous grab, at the nominal frame rate
+    qint64 now = visionClockNs();
+    double intervalNs = m_frameIntervalNs;
+    int waiting = m_grabTimeNs > 0 ? static_cast<int>((now - m_grabTimeNs) / intervalNs) : 0;
+    if (waiting > 1)
+    {
+        m_lateFrames++;
+    }
+
+    // Skip the stale frames without decoding them. A grab that has to wait for the device
+    // means the queue was shorter than estimated and the grabbed frame is already the newest.
+    int skip = m_captureMode == Freshest ? std::min(waiting - 1, MAX_DRAIN_GRABS) : 0;
+    QElapsedTimer grabTimer;
+    for (int i = 0; i < skip; i++)
+    {
+        grabTimer.start();
+        if (!m_capture.grab())
+        {
+            return false;
+        }
+        if (grabTimer.nsecsElapsed() > intervalNs / 2)
+        {
+            m_grabTimeNs = visionClockNs();
+            return m_capture.retrieve(frame);
+        }
+        m_droppedFrames++;
+    }
+
+    if (!m_capture.grab())
+    {
+        return false;
+    }
+    m_grabTimeNs = visionClockNs();
+    return m_capture.retrieve(frame);
+}
+
+QSize CameraFrameSource::frameSize() const
+{
+    if (!m_capture.isOpened())
+    {
+        return QSize();
+    }
+    return QSize(m_capture.get(CAP_PROP_FRAME_WIDTH), m_capture.get(CAP_PROP_FRAME_HEIGHT));
+}
+
+double CameraFrameSource::frameRate() const
+{
+    double fps = m_capture.get(CAP_PROP_FPS);
+    return fps > 0.0 ? fps : 30.0;
+}
+
+VideoFileFrameSource::VideoFileFrameSource(const QString &fileName, Pacing pacing)
+    : FrameSource(pacing),
+      m_fileName(fileName),
+      m_atEnd(false)
+{
+    m_capture.open(fileName.toStdString());
+}
+
+QSize VideoFileFrameSource::frameSize() const
+{
+    if (!m_capture.isOpened())
+    {
+        return QSize();
+    }
+    return QSize(m_capture.get(CAP_PROP_FRAME_WIDTH), m_capture.get(CAP_PROP_FRAME_HEIGHT));
+}
+
+double VideoFileFrameSource::frameRate() const
+{
+    // Some containers do not store the frame rate
+    double fps = m_capture.get(CAP_PROP_FPS);
+    return fps > 0.0 ? fps : 30.0;
+}
+
+bool VideoFileFrameSource::readFrame(Mat &frame)
+{
+    if (m_atEnd || !m_capture.read(frame))
+    {
+        m_atEnd = true;
+        return false;
+    }
+    return true;
+}
+
+ImageSequenceFrameSource::ImageSequenceFrameSource(const QString &directory, double frameRate, Pacing pacing)
+    : FrameSource(pacing),
+      m_directory(directory),
+      m_nextIndex(0),
+      m_frameRate(frameRate > 0.0 ? frameRate : 30.0)
+{
+    QDir dir(directory);
+    QStringList filters;
+    filters << "*.png" << "*.jpg" << "*.jpeg" << "*.bmp";
+    QFileInfoList entries = dir.entryInfoList(filters, QDir::Files, QDir::Name);
+    for (const QFileInfo &entry : entries)
+    {
+        m_files << entry.absoluteFilePath();
+    }
+
+    // Read the size from the first image, the sequence is expected to be uniform
+    if (!m_files.isEmpty())
+    {
+        Mat first = imread(m_files.first().toStdString(), IMREAD_COLOR);
+        if (!first.empty())
+        {
+            m_frameSize = QSize(first.cols, first.rows);
+        }
+    }
+}
+
+QString ImageSequenceFrameSource::currentFileName() const
+{
+    if (m_nextIndex <= 0 || m_nextIndex > m_files.size())
+    {
+        return QString();
+    }
+    return QFileInfo(m_files.at(m_nextIndex - 1)).fileName();
+}
+
+bool ImageSequenceFrameSource::readFrame(Mat &frame)
+{
+    if (atEnd())
+    {
+        return false;
+    }
+
+    frame = imread(m_files.at(m_nextIndex).toStdString(), IMREAD_COLOR);
+    ++m_nextIndex;
+    return !frame.empty();
+}
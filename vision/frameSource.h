@@ -0,0 +1,283 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include "opencv2/opencv.hpp"
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QElapsedTimer>
+
+using namespace cv;
+
+/**
+ * @brief The FrameSource class is the interface of everything that delivers BGR frames to the vision pipeline
+ *
+ * Implementations exist for a live camera, a video file and a directory of images, so that
+ * detection and tracking can run on recorded sessions on machines without a webcam.
+ *
+ * Recorded sources can be replayed at their nominal frame rate (RealTime) or as fast as
+ * the pipeline consumes them (AsFastAsPossible). A live camera is always paced by the device.
+ */
+class FrameSource
+{
+public:
+    /**
+     * @brief Pacing of the frames delivered by read()
+     */
+    enum Pacing
+    {
+        RealTime,        // Frames are delivered at the nominal frame rate of the source
+        AsFastAsPossible // Frames are delivered as soon as they are requested
+    };
+
+    /**
+     * @brief Constructor
+     * @param pacing Pacing of the delivered frames
+     */
+    explicit FrameSource(Pacing pacing = RealTime);
+
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~FrameSource() {}
+
+    /**
+     * @brief Reads the next frame, waiting for its due time in RealTime pacing
+     * @param frame Receives the BGR frame
+     * @return true if a frame was read, false on error or at the end of the stream
+     */
+    bool read(Mat &frame);
+
+    /**
+     * @brief Check if the source can deliver frames
+     * @return true if the source is opened
+     */
+    virtual bool isOpened() const = 0;
+
+    /**
+     * @brief Releases the underlying device or files
+     */
+    virtual void release() = 0;
+
+    /**
+     * @brief Get the size of the delivered frames
+     * @return Frame size in pixels (empty if unknown)
+     */
+    virtual QSize frameSize() const = 0;
+
+    /**
+     * @brief Get the nominal frame rate of the source
+     * @return Frames per second
+     */
+    virtual double frameRate() const = 0;
+
+    /**
+     * @brief Check if the frames come from a live device
+     * @return true for a camera, false for recorded sources
+     */
+    virtual bool isLive() const { return false; }
+
+    /**
+     * @brief Check if a recorded source has delivered all its frames
+     * @return true at the end of the stream
+     */
+    virtual bool atEnd() const { return false; }
+
+    /**
+     * @brief Get the time the last frame was captured
+     * @return visionClockNs() timestamp of the frame returned by the last successful read()
+     */
+    virtual qint64 captureTimeNs() const { return m_readTimeNs; }
+
+    /**
+     * @brief Get the number of frames skipped to deliver fresher ones
+     * @return Frames grabbed from the device but never decoded nor delivered
+     */
+    virtual quint64 droppedFrames() const { return 0; }
+
+    /**
+     * @brief Get the number of frames read after the processing fell behind the source
+     * @return Reads that came more than one frame interval after the previous one, with stale frames queued
+     */
+    virtual quint64 lateFrames() const { return 0; }
+
+    /**
+     * @brief Get a short description of the source for the user interface
+     * @return Description such as "camera 0" or the file name
+     */
+    virtual QString description() const = 0;
+
+    /**
+     * @brief Get the pacing of the source
+     * @return Current pacing
+     */
+    Pacing pacing() const { return m_pacing; }
+
+    /**
+     * @brief Changes the pacing of the source
+     * @param pacing New pacing, the replay clock restarts on the next frame
+     */
+    void setPacing(Pacing pacing);
+
+    /**
+     * @brief Creates a recorded source from a path
+     * @param path Video file or directory of images
+     * @param pacing Pacing of the delivered frames
+     * @return Opened source owned by the caller, nullptr if the path cannot be opened
+     */
+    static FrameSource *createFromPath(const QString &path, Pacing pacing = RealTime);
+
+protected:
+    /**
+     * @brief Reads the next frame of the source without any pacing
+     * @param frame Receives the BGR frame
+     * @return true if a frame was read
+     */
+    virtual bool readFrame(Mat &frame) = 0;
+
+private:
+    Pacing m_pacing; // Pacing of the delivered frames
+    QElapsedTimer m_replayClock; // Time since the first frame of the replay
+    qint64 m_framesDelivered; // Frames delivered since the replay clock started
+    qint64 m_readTimeNs; // Time the last frame was delivered by read()
+};
+
+/**
+ * @brief Frames read from a webcam
+ *
+ * The driver keeps a small queue of captured frames. When the processing of a frame
+ * takes longer than the frame interval, the queue fills up and each read returns a
+ * frame that is several intervals old. In Freshest mode, a read grabs the frames
+ * waiting in the queue without decoding them, and only decodes the newest one, so
+ * the delivered frame is at most about one interval old whatever the processing time.
+ */
+class CameraFrameSource : public FrameSource
+{
+public:
+    /**
+     * @brief Frames delivered by read()
+     */
+    enum CaptureMode
+    {
+        Sequential, // Every frame of the device queue is delivered, in order
+        Freshest    // Stale queued frames are skipped, only the newest one is decoded
+    };
+
+    /**
+     * @brief Constructor opens the camera
+     * @param cameraIndex Index of the camera to open (0 = internal, 1 = external)
+     * @param mode Frames delivered by read()
+     */
+    explicit CameraFrameSource(int cameraIndex, CaptureMode mode = Freshest);
+
+    bool isOpened() const override { return m_capture.isOpened(); }
+    void release() override { m_capture.release(); }
+    QSize frameSize() const override;
+    double frameRate() const override;
+    bool isLive() const override { return true; }
+    QString description() const override { return QString("camera %1").arg(m_cameraIndex); }
+    qint64 captureTimeNs() const override { return m_grabTimeNs; }
+    quint64 droppedFrames() const override { return m_droppedFrames; }
+    quint64 lateFrames() const override { return m_lateFrames; }
+
+    /**
+     * @brief Get the capture mode
+     * @return Current mode
+     */
+    CaptureMode captureMode() const { return m_captureMode; }
+
+    /**
+     * @brief Changes the capture mode, applied from the next read
+     * @param mode New mode, Freshest also asks the driver for a single buffer where supported
+     */
+    void setCaptureMode(CaptureMode mode);
+
+protected:
+    bool readFrame(Mat &frame) override;
+
+private:
+    VideoCapture m_capture; // Webcam capture object
+    int m_cameraIndex; // Index of the opened camera
+    CaptureMode m_captureMode; // Frames delivered by read()
+    double m_frameIntervalNs; // Nominal frame interval, read from the driver when the camera opens
+    qint64 m_grabTimeNs; // Time the delivered frame was grabbed from the driver (0 before the first frame)
+    quint64 m_droppedFrames; // Frames grabbed and skipped in Freshest mode
+    quint64 m_lateFrames; // Reads that found stale frames waiting in the queue
+
+    static const int MAX_DRAIN_GRABS = 8; // Most frames skipped by one read, above the usual driver queue length
+};
+
+/**
+ * @brief Frames decoded from a video file
+ */
+class VideoFileFrameSource : public FrameSource
+{
+public:
+    /**
+     * @brief Constructor opens the video file
+     * @param fileName Path of the video file
+     * @param pacing Pacing of the delivered frames
+     */
+    explicit VideoFileFrameSource(const QString &fileName, Pacing pacing = RealTime);
+
+    bool isOpened() const override { return m_capture.isOpened(); }
+    void release() override { m_capture.release(); }
+    QSize frameSize() const override;
+    double frameRate() const override;
+    bool atEnd() const override { return m_atEnd; }
+    QString description() const override { return m_fileName; }
+
+protected:
+    bool readFrame(Mat &frame) override;
+
+private:
+    VideoCapture m_capture; // Video decoder
+    QString m_fileName; // Path of the video file
+    bool m_atEnd; // Flag indicating if the last frame has been read
+};
+
+/**
+ * @brief Frames loaded from the image files of a directory, in file name order
+ */
+class ImageSequenceFrameSource : public FrameSource
+{
+public:
+    /**
+     * @brief Constructor lists the images of the directory
+     * @param directory Directory containing the images (png, jpg, jpeg, bmp)
+     * @param frameRate Frame rate used for RealTime pacing
+     * @param pacing Pacing of the delivered frames
+     */
+    explicit ImageSequenceFrameSource(const QString &directory, double frameRate = 30.0, Pacing pacing = RealTime);
+
+    bool isOpened() const override { return !m_files.isEmpty(); }
+    void release() override { m_files.clear(); }
+    QSize frameSize() const override { return m_frameSize; }
+    double frameRate() const override { return m_frameRate; }
+    bool atEnd() const override { return m_nextIndex >= m_files.size(); }
+    QString description() const override { return m_directory; }
+
+    /**
+     * @brief Get the file name of the last delivered frame
+     * @return File name relative to the directory, empty before the first frame
+     */
+    QString currentFileName() const;
+
+    /**
+     * @brief Get the number of images in the directory
+     * @return Number of frames of the sequence
+     */
+    int frameCount() const { return m_files.size(); }
+
+protected:
+    bool readFrame(Mat &frame) override;
+
+private:
+    QString m_directory; // Directory containing the images
+    QStringList m_files; // Absolute paths of the images, sorted by name
+    int m_nextIndex; // Index of the next image to load
+    double m_frameRate; // Frame rate used for RealTime pacing
+    QSize m_frameSize; // Size of the first image
+};
+
+#endif // FRAMESOURCE_H
@@ -0,0 +1,69 @@
+#define _USE_MATH_DEFINES
+
+#include "handFilter.h"
+#include <cmath>
+
+HandFilter::HandFilter(float minCutoff, float beta, float derivativeCutoff)
+    : m_minCutoff(minCutoff),
+      m_beta(beta),
+      m_derivativeCutoff(derivativeCutoff),
+      m_initialized(false),
+      m_lastTimestampNs(0)
+{
+}
+
+float HandFilter::smoothingFactor(float cutoff, float dt)
+{
+    float tau = 1.0f / (2.0f * static_cast<float>(M_PI) * cutoff);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+void HandFilter::addSample(const QVector3D &position, qint64 timestampNs)
+{
+    if (!m_initialized)
+    {
+        m_position = position;
+        m_velocity = QVector3D(0.0f, 0.0f, 0.0f);
+        m_lastTimestampNs = timestampNs;
+        m_initialized = true;
+        return;
+    }
+
+    // Ignore out of order or duplicated samples
+    float dt = (timestampNs - m_lastTimestampNs) / 1.0e9f;
+    if (dt <= 0.0f)
+    {
+        return;
+    }
+    m_lastTimestampNs = timestampNs;
+
+    // Filter the velocity first, it drives the cutoff of the position filter
+    QVector3D rawVelocity = (position - m_position) / dt;
+    float alphaVelocity = smoothingFactor(m_derivativeCutoff, dt);
+    m_velocity = m_velocity + alphaVelocity * (rawVelocity - m_velocity);
+
+    // Faster hand, higher cutoff, less lag
+    float cutoff = m_minCutoff + m_beta * m_velocity.length();
+    float alphaPosition = smoothingFactor(cutoff, dt);
+    m_position = m_position + alphaPosition * (position - m_position);
+}
+
+QVector3D HandFilter::predict(qint64 timestampNs) const
+{
+    if (!m_initialized)
+    {
+        return QVector3D(0.0f, 0.0f, 0.0f);
+    }
+
+    float horizon = (timestampNs - m_lastTimestampNs) / 1.0e9f;
+    horizon = qBound(0.0f, horizon, MAX_PREDICTION_S);
+    return m_position + m_velocity * horizon;
+}
+
+void HandFilter::reset()
+{
+    m_initialized = false;
+    m_lastTimestampNs = 0;
+    m_position = QVector3D(0.0f, 0.0f, 0.0f);
+    m_velocity = QVector3D(0.0f, 0.0f, 0.0f);
+}
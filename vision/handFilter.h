@@ -0,0 +1,83 @@
+#ifndef HANDFILTER_H
+#define HANDFILTER_H
+
+#include <QtGlobal>
+#include <QVector3D>
+
+/**
+ * @brief Adaptive One-Euro filter with velocity based prediction for the hand position
+ *
+ * The filter smooths timestamped hand samples with a cutoff frequency that rises with
+ * the hand speed: slow movements are strongly smoothed (no jitter) while fast movements
+ * are followed closely (little lag). The filtered velocity is then used to extrapolate
+ * the position to the time a frame is rendered, which cancels the pipeline latency.
+ *
+ * See Casiez et al., "1 Euro Filter: A Simple Speed-based Low-pass Filter for Noisy
+ * Input in Interactive Systems", CHI 2012.
+ */
+class HandFilter
+{
+public:
+    /**
+     * @brief Constructor
+     * @param minCutoff Cutoff frequency at rest (Hz), lower means smoother
+     * @param beta Speed coefficient, higher means less lag during fast movements
+     * @param derivativeCutoff Cutoff frequency of the velocity estimate (Hz)
+     */
+    explicit HandFilter(float minCutoff = 1.5f, float beta = 0.7f, float derivativeCutoff = 1.0f);
+
+    /**
+     * @brief Adds a new measured position
+     * @param position Measured position (normalized coordinates)
+     * @param timestampNs Time the position was measured (visionClockNs())
+     */
+    void addSample(const QVector3D &position, qint64 timestampNs);
+
+    /**
+     * @brief Predicts the position at a given time
+     * @param timestampNs Time to predict the position at (visionClockNs())
+     * @return Filtered position extrapolated with the filtered velocity
+     *
+     * The extrapolation horizon is bounded so that a lost hand does not fly away.
+     */
+    QVector3D predict(qint64 timestampNs) const;
+
+    /**
+     * @brief Forgets all samples
+     */
+    void reset();
+
+    /**
+     * @brief Check if the filter has received at least one sample
+     * @return true if predict() returns a meaningful position
+     */
+    bool isInitialized() const { return m_initialized; }
+
+    /**
+     * @brief Get the filtered velocity
+     * @return Velocity in normalized units per second
+     */
+    QVector3D velocity() const { return m_velocity; }
+
+private:
+    /**
+     * @brief Smoothing factor of a first order low-pass filter
+     * @param cutoff Cutoff frequency (Hz)
+     * @param dt Time step (seconds)
+     * @return Smoothing factor between 0 and 1
+     */
+    static float smoothingFactor(float cutoff, float dt);
+
+    float m_minCutoff;        // Cutoff frequency at rest (Hz)
+    float m_beta;             // Speed coefficient
+    float m_derivativeCutoff; // Cutoff frequency of the velocity estimate (Hz)
+
+    bool m_initialized;       // Flag indicating if a sample has been received
+    qint64 m_lastTimestampNs; // Timestamp of the last sample
+    QVector3D m_position;     // Filtered position
+    QVector3D m_velocity;     // Filtered velocity (units per second)
+
+    static constexpr float MAX_PREDICTION_S = 0.12f; // Maximum extrapolation horizon (seconds)
+};
+
+#endif // HANDFILTER_H
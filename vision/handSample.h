@@ -0,0 +1,26 @@
+#ifndef HANDSAMPLE_H
+#define HANDSAMPLE_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Result of one vision frame, published by the vision worker
+ *
+ * Coordinates are expressed in pixels of the (mirrored) camera frame.
+ * A default constructed sample is invalid until the first frame is processed.
+ */
+struct HandSample
+{
+    int x = 0;              // Tracked hand X coordinate in frame pixels
+    int y = 0;              // Tracked hand Y coordinate in frame pixels
+    int frameWidth = 0;     // Width of the frame the sample was computed on
+    int frameHeight = 0;    // Height of the frame the sample was computed on
+    int matchQuality = 0;   // Quality of the feature match (0-100)
+    float confidence = 0.0f; // Confidence of the tracked position (0-1), 0 if not updated on this frame
+    bool valid = false;     // Flag indicating if the sample holds a tracked position
+    quint64 sequence = 0;   // Index of the processed frame, increases with each sample
+    int hand = 0;           // Index of the hand (0 = first sword, 1 = second sword)
+    qint64 timestampNs = 0; // Time the frame was captured (visionClockNs())
+};
+
+#endif // HANDSAMPLE_H
@@ -0,0 +1,88 @@
+#include "handSampleHistory.h"
+#include <algorithm>
+
+HandSampleHistory::HandSampleHistory()
+    : m_next(0),
+      m_count(0)
+{
+}
+
+void HandSampleHistory::add(qint64 timestampNs, const QVector3D &position, float confidence, quint64 sequence)
+{
+    // Samples arrive in capture order, anything older than the newest one is a duplicate
+    if (m_count > 0 && (sequence == latest().sequence || timestampNs <= latest().timestampNs))
+    {
+        return;
+    }
+
+    m_filter.addSample(position, timestampNs);
+
+    Entry &entry = m_entries[m_next];
+    entry.timestampNs = timestampNs;
+    entry.position = m_filter.predict(timestampNs);
+    entry.velocity = m_filter.velocity();
+    entry.confidence = confidence;
+    entry.sequence = sequence;
+
+    m_next = (m_next + 1) % CAPACITY;
+    m_count = std::min(m_count + 1, CAPACITY);
+}
+
+const HandSampleHistory::Entry &HandSampleHistory::at(int age) const
+{
+    return m_entries[(m_next - 1 - age + 2 * CAPACITY) % CAPACITY];
+}
+
+bool HandSampleHistory::positionAt(qint64 timeNs, QVector3D &position, float *confidence) const
+{
+    if (m_count == 0)
+    {
+        return false;
+    }
+
+    // After the newest sample: extrapolate with its velocity, for a bounded horizon only
+    const Entry &newest = latest();
+    if (timeNs >= newest.timestampNs)
+    {
+        double horizon = std::min((timeNs - newest.timestampNs) / 1.0e9, MAX_EXTRAPOLATION_S);
+        position = newest.position + newest.velocity * static_cast<float>(horizon);
+        if (confidence)
+        {
+            *confidence = newest.confidence;
+        }
+        return true;
+    }
+
+    // Between two samples: linear interpolation
+    for (int age = 1; age < m_count; age++)
+    {
+        const Entry &older = at(age);
+        if (older.timestampNs <= timeNs)
+        {
+            const Entry &newer = at(age - 1);
+            float t = float(timeNs - older.timestampNs) / float(newer.timestampNs - older.timestampNs);
+            position = older.position + (newer.position - older.position) * t;
+            if (confidence)
+            {
+                *confidence = t < 0.5f ? older.confidence : newer.confidence;
+            }
+            return true;
+        }
+    }
+
+    // Before the oldest sample
+    const Entry &oldest = at(m_count - 1);
+    position = oldest.position;
+    if (confidence)
+    {
+        *confidence = oldest.confidence;
+    }
+    return true;
+}
+
+void HandSampleHistory::clear()
+{
+    m_filter.reset();
+    m_next = 0;
+    m_count = 0;
+}
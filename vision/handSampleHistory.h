@@ -0,0 +1,90 @@
+#ifndef HANDSAMPLEHISTORY_H
+#define HANDSAMPLEHISTORY_H
+
+#include <QtGlobal>
+#include <QVector3D>
+#include "handFilter.h"
+
+/**
+ * @brief Ring buffer of the last timestamped hand positions
+ *
+ * Positions are smoothed by a HandFilter when they are added and stored with their
+ * capture time, filtered velocity and confidence. The position at any time can then
+ * be queried: between two samples it is interpolated, after the newest one it is
+ * extrapolated with the filtered velocity for a bounded horizon. This decouples the
+ * render rate from the camera rate, so the sword moves on every rendered frame.
+ */
+class HandSampleHistory
+{
+public:
+    /**
+     * @brief One stored hand position
+     */
+    struct Entry
+    {
+        qint64 timestampNs = 0; // Capture time of the frame (visionClockNs())
+        QVector3D position;     // Filtered position (normalized coordinates)
+        QVector3D velocity;     // Filtered velocity (normalized units per second)
+        float confidence = 0.0f; // Confidence of the measurement (0-1)
+        quint64 sequence = 0;   // Sequence number of the frame
+    };
+
+    /**
+     * @brief Constructor
+     */
+    HandSampleHistory();
+
+    /**
+     * @brief Adds a measured position
+     * @param timestampNs Capture time of the frame
+     * @param position Measured position (normalized coordinates)
+     * @param confidence Confidence of the measurement (0-1)
+     * @param sequence Sequence number of the frame, a sample already stored is ignored
+     */
+    void add(qint64 timestampNs, const QVector3D &position, float confidence, quint64 sequence);
+
+    /**
+     * @brief Computes the hand position at a given time
+     * @param timeNs Time to compute the position at (visionClockNs())
+     * @param position Receives the interpolated or extrapolated position
+     * @param confidence Receives the confidence of the closest sample (optional)
+     * @return false if there is no sample yet
+     */
+    bool positionAt(qint64 timeNs, QVector3D &position, float *confidence = nullptr) const;
+
+    /**
+     * @brief Forgets all samples
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of stored samples
+     * @return Sample count, at most CAPACITY
+     */
+    int size() const { return m_count; }
+
+    /**
+     * @brief Get the most recent sample
+     * @return Newest entry (default entry if empty)
+     */
+    const Entry &latest() const { return at(0); }
+
+    static const int CAPACITY = 32; // Samples kept, about one second at 30 Hz
+
+private:
+    /**
+     * @brief Get a stored sample by age
+     * @param age 0 for the newest sample, size() - 1 for the oldest
+     * @return Stored entry
+     */
+    const Entry &at(int age) const;
+
+    HandFilter m_filter;        // Smoothing applied to the added positions
+    Entry m_entries[CAPACITY];  // Ring of the samples
+    int m_next;                 // Index written by the next sample
+    int m_count;                // Number of valid samples in the ring
+
+    static constexpr double MAX_EXTRAPOLATION_S = 0.12; // Extrapolation horizon past the newest sample (seconds)
+};
+
+#endif // HANDSAMPLEHISTORY_H
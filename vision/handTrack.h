@@ -0,0 +1,38 @@
+#ifndef HANDTRACK_H
+#define HANDTRACK_H
+
+#include "opencv2/opencv.hpp"
+#include "opticalFlowTracker.h"
+
+using namespace cv;
+
+/**
+ * @brief Tracking state of an additional hand
+ *
+ * The first hand keeps the full pipeline (reference capture and feature matching).
+ * Additional hands reuse the detections of the same frame and are followed by their
+ * own optical flow tracker on the shared pyramid in between, so they add no detector pass.
+ */
+struct HandTrack
+{
+    OpticalFlowTracker flow;  // Flow tracker following the hand between detections
+    Rect rect;                // Last region of the hand in frame coordinates
+    Point position;           // Tracked position in frame coordinates
+    double confidence = 0.0;  // Confidence of the position tracked on the last frame (0-1)
+    int missedDetections = 0; // Consecutive detections that did not find the hand
+    bool tracked = false;     // Flag indicating if the hand is currently followed
+
+    /**
+     * @brief Forgets the hand
+     */
+    void reset()
+    {
+        flow.reset();
+        rect = Rect();
+        confidence = 0.0;
+        missedDetections = 0;
+        tracked = false;
+    }
+};
+
+#endif // HANDTRACK_H
@@ -0,0 +1,63 @@
+#include "handTracker.h"
+#include "featureHandTracker.h"
+#include "templateHandTracker.h"
+#include <QElapsedTimer>
+
+HandTracker *HandTracker::create(Backend backend, float ratioThreshold)
+{
+    // Binary descriptors are less discriminative than SIFT, their default ratio is stricter
+    float defaultRatio = (backend == Orb || backend == Brisk || backend == Akaze) ? 0.8f : 0.85f;
+    float ratio = ratioThreshold > 0.0f ? ratioThreshold : defaultRatio;
+
+    switch (backend)
+    {
+    case Orb:
+        // Smaller edge threshold and patch size than the defaults so that
+        // small hand patches still produce keypoints
+        return new FeatureHandTracker(Orb, ORB::create(500, 1.2f, 8, 15, 0, 2, ORB::HARRIS_SCORE, 15),
+                                      BFMatcher::create(NORM_HAMMING), ratio);
+    case Brisk:
+        return new FeatureHandTracker(Brisk, BRISK::create(), BFMatcher::create(NORM_HAMMING), ratio);
+    case Akaze:
+        return new FeatureHandTracker(Akaze, AKAZE::create(), BFMatcher::create(NORM_HAMMING), ratio);
+    case Template:
+        return new TemplateHandTracker();
+    case Sift:
+    default:
+        return new FeatureHandTracker(Sift, SIFT::create(), FlannBasedMatcher::create(), ratio);
+    }
+}
+
+QStringList HandTracker::backendNames()
+{
+    return QStringList() << "SIFT" << "ORB" << "BRISK" << "AKAZE" << "Template";
+}
+
+TrackResult HandTracker::track(const Mat &frame, const Rect &roi)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    TrackResult result = trackRoi(frame, roi);
+
+    m_lastCostMs = timer.nsecsElapsed() / 1.0e6;
+    result.costMs = m_lastCostMs;
+    return result;
+}
+
+TrackResult HandTracker::track(const Mat &frame, const Rect &roi, RoiFeatures &features)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    TrackResult result = trackRoi(frame, roi, features);
+
+    m_lastCostMs = timer.nsecsElapsed() / 1.0e6;
+    result.costMs = m_lastCostMs;
+    return result;
+}
+
+TrackResult HandTracker::trackRoi(const Mat &frame, const Rect &roi, RoiFeatures &)
+{
+    return trackRoi(frame, roi);
+}
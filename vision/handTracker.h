@@ -0,0 +1,137 @@
+#ifndef HANDTRACKER_H
+#define HANDTRACKER_H
+
+#include "opencv2/opencv.hpp"
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+using namespace cv;
+
+/**
+ * @brief Output of one tracking step
+ */
+struct TrackResult
+{
+    bool found = false;          // Flag indicating if the tracker produced a position
+    Point2f position;            // Estimated hand position in frame coordinates
+    int matchQuality = 0;        // Quality of the match against the reference (0-100)
+    std::vector<Point2f> points; // Feature points used for the estimate, in frame coordinates
+    double costMs = 0.0;         // Time spent in the tracking step (milliseconds)
+    double describeMs = 0.0;     // Part of costMs spent detecting and describing keypoints
+    double matchMs = 0.0;        // Part of costMs spent matching against the reference
+};
+
+/**
+ * @brief Keypoints and descriptors of a region of interest, described once and shared by the trackers of a backend
+ */
+struct RoiFeatures
+{
+    bool described = false;          // Flag indicating if the keypoints and descriptors hold the current region
+    std::vector<KeyPoint> keypoints; // Keypoints in region coordinates
+    Mat descriptors;                 // Descriptors of the keypoints
+};
+
+/**
+ * @brief The HandTracker class is the interface of the hand tracking backends
+ *
+ * Once a reference image of the hand has been captured, a tracker locates the hand
+ * in a region of interest of each frame and reports a match quality together with
+ * the time the step took. Backends are created with create() and can be swapped at
+ * runtime by giving the new backend the same reference image.
+ */
+class HandTracker
+{
+public:
+    /**
+     * @brief Available tracking backends
+     */
+    enum Backend
+    {
+        Sift = 0, // SIFT descriptors with a FLANN matcher (most robust, slowest)
+        Orb,      // ORB binary descriptors with a Hamming brute-force matcher
+        Brisk,    // BRISK binary descriptors with a Hamming brute-force matcher
+        Akaze,    // AKAZE binary descriptors with a Hamming brute-force matcher
+        Template, // Normalized cross-correlation with the reference patch (cheapest, pose sensitive)
+        BackendCount
+    };
+
+    /**
+     * @brief Creates a tracker for the given backend
+     * @param backend Backend to create
+     * @param ratioThreshold Lowe ratio test threshold, 0 to use the default of the backend
+     *                       (not used by the Template backend)
+     * @return New tracker, owned by the caller
+     */
+    static HandTracker *create(Backend backend, float ratioThreshold = 0.0f);
+
+    /**
+     * @brief Get the display names of all backends, indexed by Backend
+     * @return List of backend names
+     */
+    static QStringList backendNames();
+
+    virtual ~HandTracker() = default;
+
+    /**
+     * @brief Get the backend implemented by this tracker
+     * @return Backend identifier
+     */
+    virtual Backend backend() const = 0;
+
+    /**
+     * @brief Sets the reference image of the hand and precomputes what matching needs
+     * @param reference Reference image (BGR)
+     * @return true if the reference can be tracked
+     */
+    virtual bool setReference(const Mat &reference) = 0;
+
+    /**
+     * @brief Locates the hand inside a region of interest of the frame
+     * @param frame Current frame (BGR or grayscale)
+     * @param roi Region of interest, already clipped to the frame
+     * @return Tracking result, with the cost of the step filled in
+     */
+    TrackResult track(const Mat &frame, const Rect &roi);
+
+    /**
+     * @brief Locates the hand with the features of the region of interest, described on the first use
+     * @param frame Current frame (BGR or grayscale)
+     * @param roi Region of interest, already clipped to the frame
+     * @param features Features of the region: used as is when described, otherwise filled in by the
+     *                 tracker for the next trackers of the same backend (ignored by the Template backend)
+     * @return Tracking result, with the cost of the step filled in
+     */
+    TrackResult track(const Mat &frame, const Rect &roi, RoiFeatures &features);
+
+    /**
+     * @brief Get the cost of the last tracking step
+     * @return Duration of the last call to track() in milliseconds
+     */
+    double lastCostMs() const { return m_lastCostMs; }
+
+protected:
+    /**
+     * @brief Backend specific tracking step, timed by track()
+     * @param frame Current frame (BGR)
+     * @param roi Region of interest, already clipped to the frame
+     * @return Tracking result (costMs is filled in by the caller)
+     */
+    virtual TrackResult trackRoi(const Mat &frame, const Rect &roi) = 0;
+
+    /**
+     * @brief Backend specific tracking step with shared region features, timed by track()
+     * @param frame Current frame (BGR)
+     * @param roi Region of interest, already clipped to the frame
+     * @param features Features of the region, described by the first tracker that needs them
+     * @return Tracking result (costMs is filled in by the caller)
+     *
+     * The default implementation ignores the features and calls trackRoi(frame, roi).
+     */
+    virtual TrackResult trackRoi(const Mat &frame, const Rect &roi, RoiFeatures &features);
+
+private:
+    double m_lastCostMs = 0.0; // Cost of the last tracking step (milliseconds)
+};
+
+#endif // HANDTRACKER_H
@@ -0,0 +1,55 @@
+#include "latencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram(int capacity)
+    : m_samples(std::max(1, capacity), 0.0),
+      m_next(0),
+      m_count(0)
+{
+    m_sorted.reserve(m_samples.size());
+}
+
+void LatencyHistogram::add(double ms)
+{
+    m_samples[m_next] = ms;
+    m_next = (m_next + 1) % static_cast<int>(m_samples.size());
+    m_count = std::min(m_count + 1, static_cast<int>(m_samples.size()));
+}
+
+void LatencyHistogram::clear()
+{
+    m_next = 0;
+    m_count = 0;
+}
+
+double LatencyHistogram::percentile(double percent) const
+{
+    if (m_count == 0)
+    {
+        return 0.0;
+    }
+
+    // Nearest-rank percentile on a copy, the ring keeps its insertion order
+    m_sorted.assign(m_samples.begin(), m_samples.begin() + m_count);
+    int rank = static_cast<int>(std::ceil(percent / 100.0 * m_count)) - 1;
+    rank = std::max(0, std::min(m_count - 1, rank));
+    std::nth_element(m_sorted.begin(), m_sorted.begin() + rank, m_sorted.end());
+    return m_sorted[rank];
+}
+
+LatencySummary LatencyHistogram::summary() const
+{
+    LatencySummary summary;
+    summary.count = m_count;
+    if (m_count == 0)
+    {
+        return summary;
+    }
+
+    summary.p50 = percentile(50.0);
+    summary.p95 = percentile(95.0);
+    summary.p99 = percentile(99.0);
+    summary.max = *std::max_element(m_samples.begin(), m_samples.begin() + m_count);
+    return summary;
+}
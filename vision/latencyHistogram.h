@@ -0,0 +1,71 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <vector>
+
+/**
+ * @brief Percentiles of a latency distribution, in milliseconds
+ */
+struct LatencySummary
+{
+    double p50 = 0.0;  // Median
+    double p95 = 0.0;  // 95th percentile
+    double p99 = 0.0;  // 99th percentile
+    double max = 0.0;  // Largest sample
+    int count = 0;     // Number of samples the percentiles are computed on
+};
+
+/**
+ * @brief Rolling latency distribution over the last samples
+ *
+ * Samples are kept in a fixed size ring, so old measurements fall out of the
+ * distribution and adding a sample never allocates. Percentiles are computed on
+ * demand with a partial sort of a copy of the ring.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Number of most recent samples kept
+     */
+    explicit LatencyHistogram(int capacity = 256);
+
+    /**
+     * @brief Adds a measurement
+     * @param ms Duration in milliseconds
+     */
+    void add(double ms);
+
+    /**
+     * @brief Removes all the samples
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of samples currently kept
+     * @return Sample count, at most the capacity
+     */
+    int count() const { return m_count; }
+
+    /**
+     * @brief Computes a percentile of the kept samples
+     * @param percent Percentile between 0 and 100
+     * @return Duration in milliseconds, 0 if there is no sample
+     */
+    double percentile(double percent) const;
+
+    /**
+     * @brief Computes the usual percentiles of the kept samples
+     * @return p50, p95, p99 and max
+     */
+    LatencySummary summary() const;
+
+private:
+    std::vector<double> m_samples;         // Ring of the last samples
+    int m_next;                            // Index written by the next sample
+    int m_count;                           // Number of valid samples in the ring
+    mutable std::vector<double> m_sorted;  // Work buffer of the percentile computation
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,141 @@
+#include "latencyProbe.h"
+#include <QMutexLocker>
+
+LatencyProbe::LatencyProbe()
+    : m_enabled(false),
+      m_nextRecord(0),
+      m_sinceCapture(HopCount, LatencyHistogram(HISTOGRAM_CAPACITY)),
+      m_sincePrevious(HopCount, LatencyHistogram(HISTOGRAM_CAPACITY)),
+      m_completed(0)
+{
+}
+
+LatencyProbe &LatencyProbe::instance()
+{
+    static LatencyProbe probe;
+    return probe;
+}
+
+void LatencyProbe::setEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void LatencyProbe::mark(Hop hop, quint64 sequence, qint64 timeNs)
+{
+    if (!isEnabled() || sequence == 0)
+    {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    // A new frame starts at the capture and takes the oldest slot of the ring
+    if (hop == Capture)
+    {
+        Record &record = m_records[m_nextRecord];
+        record = Record();
+        record.sequence = sequence;
+        record.hopNs[Capture] = timeNs;
+        m_nextRecord = (m_nextRecord + 1) % RECORD_COUNT;
+        return;
+    }
+
+    for (Record &record : m_records)
+    {
+        if (record.sequence == sequence)
+        {
+            if (record.hopNs[hop] == 0)
+            {
+                record.hopNs[hop] = timeNs;
+                if (hop == FrameSwapped)
+                {
+                    complete(record);
+                }
+            }
+            return;
+        }
+    }
+}
+
+void LatencyProbe::markLatest(Hop hop, qint64 timeNs)
+{
+    if (!isEnabled() || hop == Capture)
+    {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    // Most recent frame that reached the previous hop but not this one yet
+    Record *latest = nullptr;
+    for (Record &record : m_records)
+    {
+        if (record.sequence != 0 && record.hopNs[hop - 1] != 0 && record.hopNs[hop] == 0 &&
+            (!latest || record.sequence > latest->sequence))
+        {
+            latest = &record;
+        }
+    }
+
+    if (latest)
+    {
+        latest->hopNs[hop] = timeNs;
+        if (hop == FrameSwapped)
+        {
+            complete(*latest);
+        }
+    }
+}
+
+void LatencyProbe::complete(const Record &record)
+{
+    for (int hop = Published; hop < HopCount; hop++)
+    {
+        m_sinceCapture[hop].add((record.hopNs[hop] - record.hopNs[Capture]) / 1.0e6);
+        m_sincePrevious[hop].add((record.hopNs[hop] - record.hopNs[hop - 1]) / 1.0e6);
+    }
+    m_completed++;
+}
+
+QString LatencyProbe::hopName(Hop hop)
+{
+    switch (hop)
+    {
+    case Capture:
+        return "capture";
+    case Published:
+        return "sample published";
+    case GameUpdate:
+        return "game update";
+    case PositionSignal:
+        return "position signal";
+    case PositionApplied:
+        return "position applied";
+    case FrameSwapped:
+        return "frame swapped";
+    default:
+        return QString();
+    }
+}
+
+QString LatencyProbe::report() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QString report = QString("Motion-to-photon latency over %1 frames (ms)\n").arg(m_completed);
+    report += QString("%1 | %2 %3 %4 | %5 %6 %7\n")
+                  .arg("hop", -18)
+                  .arg("p50", 7).arg("p95", 7).arg("p99", 7)
+                  .arg("+p50", 7).arg("+p95", 7).arg("+p99", 7);
+    for (int hop = Published; hop < HopCount; hop++)
+    {
+        LatencySummary total = m_sinceCapture[hop].summary();
+        LatencySummary step = m_sincePrevious[hop].summary();
+        report += QString("%1 | %2 %3 %4 | %5 %6 %7\n")
+                      .arg(hopName(static_cast<Hop>(hop)), -18)
+                      .arg(total.p50, 7, 'f', 2).arg(total.p95, 7, 'f', 2).arg(total.p99, 7, 'f', 2)
+                      .arg(step.p50, 7, 'f', 2).arg(step.p95, 7, 'f', 2).arg(step.p99, 7, 'f', 2);
+    }
+    return report;
+}
@@ -0,0 +1,118 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <QtGlobal>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <vector>
+#include "latencyHistogram.h"
+#include "visionClock.h"
+
+/**
+ * @brief Motion-to-photon latency probe
+ *
+ * Each camera frame is followed by its sequence number through the hops between the
+ * capture and the swap of the first rendered frame showing its effect. Every hop is
+ * timestamped with visionClockNs(); once the swap is reached, the delay of each hop
+ * since the capture is added to a per-hop histogram.
+ *
+ * Disabled by default: mark() then returns after a single atomic load.
+ * The probe can be marked from the vision thread and the GUI thread.
+ */
+class LatencyProbe
+{
+public:
+    /**
+     * @brief Hops followed by a frame, in pipeline order
+     */
+    enum Hop
+    {
+        Capture = 0,     // Frame read from the source
+        Published,       // Hand sample published by the vision worker
+        GameUpdate,      // Sample consumed by Game::updatePlayerPosition()
+        PositionSignal,  // playerPositionChanged emitted
+        PositionApplied, // MyGLWidget::positionPlayerOnGrid() applied the position
+        FrameSwapped,    // Rendered frame swapped to the screen
+        HopCount
+    };
+
+    /**
+     * @brief Get the application wide probe
+     * @return Probe instance
+     */
+    static LatencyProbe &instance();
+
+    /**
+     * @brief Enables or disables the measurement
+     * @param enabled true to start recording hops
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * @brief Check if the measurement is running
+     * @return true if hops are recorded
+     */
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Timestamps a hop of a frame
+     * @param hop Hop reached
+     * @param sequence Sequence number of the frame (HandSample::sequence)
+     * @param timeNs Time the hop was reached
+     *
+     * Only the first mark of a hop counts for a frame.
+     */
+    void mark(Hop hop, quint64 sequence, qint64 timeNs = visionClockNs());
+
+    /**
+     * @brief Timestamps a hop for the most recent frame that reached the previous hop
+     * @param hop Hop reached (after GameUpdate, where the sequence is no longer known)
+     * @param timeNs Time the hop was reached
+     */
+    void markLatest(Hop hop, qint64 timeNs = visionClockNs());
+
+    /**
+     * @brief Get the name of a hop
+     * @param hop Hop
+     * @return Short name such as "capture" or "swap"
+     */
+    static QString hopName(Hop hop);
+
+    /**
+     * @brief Formats the latency distribution of each hop
+     * @return One line per hop with the percentiles since capture and since the previous hop
+     */
+    QString report() const;
+
+private:
+    LatencyProbe();
+
+    /**
+     * @brief Timestamps of one frame
+     */
+    struct Record
+    {
+        quint64 sequence = 0;       // Sequence number of the frame
+        qint64 hopNs[HopCount] = {}; // Time each hop was reached (0 = not yet)
+    };
+
+    /**
+     * @brief Adds the delays of a completed record to the histograms
+     * @param record Record that reached the last hop
+     */
+    void complete(const Record &record);
+
+    static const int RECORD_COUNT = 64;         // Frames followed at the same time
+    static const int HISTOGRAM_CAPACITY = 4096; // Frames kept in the distributions (over 2 minutes at 30 Hz)
+
+    std::atomic<bool> m_enabled;        // Flag indicating if hops are recorded
+    mutable QMutex m_mutex;             // Protects the records and the histograms
+    Record m_records[RECORD_COUNT];     // Ring of the frames in flight
+    int m_nextRecord;                   // Index of the ring slot used by the next frame
+    std::vector<LatencyHistogram> m_sinceCapture;  // Delay of each hop since the capture
+    std::vector<LatencyHistogram> m_sincePrevious; // Delay of each hop since the previous one
+    int m_completed;                    // Number of frames followed up to the swap
+};
+
+#endif // LATENCYPROBE_H
@@ -0,0 +1,97 @@
+#ifndef LATESTVALUEMAILBOX_H
+#define LATESTVALUEMAILBOX_H
+
+#include <atomic>
+
+/**
+ * @brief Lock-free single-producer/single-consumer "latest value" mailbox
+ *
+ * Implemented as a triple buffer: the producer always owns a back buffer and the
+ * consumer a front buffer, the third one is swapped atomically between them.
+ * Neither side ever blocks; the consumer simply sees the most recently published
+ * value and intermediate values are overwritten.
+ *
+ * The producer methods must only be called from one thread and the consumer
+ * methods from one other thread.
+ *
+ * @tparam T Copyable value type
+ */
+template <typename T>
+class LatestValueMailbox
+{
+public:
+    LatestValueMailbox() : m_back(0), m_middle(1), m_front(2) {}
+
+    /**
+     * @brief Publishes a new value (producer side)
+     * @param value Value to publish
+     */
+    void publish(const T &value)
+    {
+        backBuffer() = value;
+        publishBackBuffer();
+    }
+
+    /**
+     * @brief Get the buffer owned by the producer, to fill it in place (producer side)
+     * @return Buffer published by the next publishBackBuffer() call
+     *
+     * The buffer holds an older value: with large values such as images the producer
+     * can overwrite it without reallocating.
+     */
+    T &backBuffer() { return m_buffers[m_back]; }
+
+    /**
+     * @brief Publishes the buffer filled through backBuffer() (producer side)
+     */
+    void publishBackBuffer()
+    {
+        // Hand the filled buffer over and take back whichever buffer was in the middle
+        int previous = m_middle.exchange(m_back | DIRTY_BIT, std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief Reads the most recently published value (consumer side)
+     * @param value Receives the latest value (unchanged content if nothing was ever published)
+     * @return true if the value was published since the previous read
+     */
+    bool read(T &value)
+    {
+        bool fresh = acquire();
+        value = front();
+        return fresh;
+    }
+
+    /**
+     * @brief Takes ownership of the most recently published buffer, without copying it (consumer side)
+     * @return true if a value was published since the previous call
+     */
+    bool acquire()
+    {
+        if (m_middle.load(std::memory_order_relaxed) & DIRTY_BIT)
+        {
+            int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & INDEX_MASK;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get the buffer owned by the consumer (consumer side)
+     * @return Latest acquired value, valid until the next acquire() or read()
+     */
+    const T &front() const { return m_buffers[m_front]; }
+
+private:
+    static constexpr int INDEX_MASK = 0x3; // Bits holding the buffer index
+    static constexpr int DIRTY_BIT = 0x4;  // Set when the middle buffer holds an unread value
+
+    T m_buffers[3];            // Back, middle and front buffers
+    int m_back;                // Index of the buffer owned by the producer
+    std::atomic<int> m_middle; // Index of the shared buffer plus the dirty bit
+    int m_front;               // Index of the buffer owned by the consumer
+};
+
+#endif // LATESTVALUEMAILBOX_H
@@ -0,0 +1,121 @@
+#include "opticalFlowTracker.h"
+#include <algorithm>
+
+void FlowPyramid::build(const Mat &gray, quint64 frameIndex)
+{
+    buildOpticalFlowPyramid(gray, levels, Size(WINDOW_SIZE, WINDOW_SIZE), MAX_LEVEL);
+    size = gray.size();
+    frame = frameIndex;
+}
+
+OpticalFlowTracker::OpticalFlowTracker()
+    : m_frame(0),
+      m_seedCount(0),
+      m_confidence(0.0),
+      m_active(false)
+{
+}
+
+bool OpticalFlowTracker::seed(const FlowPyramid &pyramid, const Mat &gray, const Rect &roi, const Point2f &position)
+{
+    reset();
+
+    if (gray.empty() || roi.empty() || pyramid.frame == 0)
+    {
+        return false;
+    }
+
+    // Corners inside the detected region are the easiest points to follow
+    std::vector<Point2f> corners;
+    goodFeaturesToTrack(gray(roi), corners, MAX_POINTS, 0.01, 5.0);
+    if (static_cast<int>(corners.size()) < MIN_POINTS)
+    {
+        return false;
+    }
+
+    for (Point2f &corner : corners)
+    {
+        corner += Point2f(static_cast<float>(roi.x), static_cast<float>(roi.y));
+    }
+
+    m_frame = pyramid.frame;
+    m_points = corners;
+    m_seedCount = corners.size();
+    m_position = position;
+    m_rect = roi;
+    m_confidence = 1.0;
+    m_active = true;
+    return true;
+}
+
+bool OpticalFlowTracker::update(const FlowPyramid &previous, const FlowPyramid &current)
+{
+    // The points can only be followed from the frame they were last seen on
+    if (!m_active || previous.frame != m_frame || current.frame == 0 || previous.size != current.size)
+    {
+        reset();
+        return false;
+    }
+
+    // Track forward, then back again to reject points that do not come back to where they started.
+    // The pyramids are prebuilt, the work vectors are members so their capacity is reused from one frame to the next.
+    Size window(FlowPyramid::WINDOW_SIZE, FlowPyramid::WINDOW_SIZE);
+    calcOpticalFlowPyrLK(previous.levels, current.levels, m_points, m_nextPoints, m_status, m_error,
+                         window, FlowPyramid::MAX_LEVEL);
+    calcOpticalFlowPyrLK(current.levels, previous.levels, m_nextPoints, m_backPoints, m_backStatus, m_backError,
+                         window, FlowPyramid::MAX_LEVEL);
+
+    m_kept.clear();
+    m_dx.clear();
+    m_dy.clear();
+    for (size_t i = 0; i < m_points.size(); i++)
+    {
+        if (!m_status[i] || !m_backStatus[i])
+        {
+            continue;
+        }
+
+        Point2f diff = m_backPoints[i] - m_points[i];
+        if (diff.dot(diff) > MAX_FB_ERROR * MAX_FB_ERROR)
+        {
+            continue;
+        }
+
+        m_kept.push_back(m_nextPoints[i]);
+        m_dx.push_back(m_nextPoints[i].x - m_points[i].x);
+        m_dy.push_back(m_nextPoints[i].y - m_points[i].y);
+    }
+
+    m_confidence = m_seedCount > 0 ? double(m_kept.size()) / m_seedCount : 0.0;
+    if (static_cast<int>(m_kept.size()) < MIN_POINTS)
+    {
+        reset();
+        return false;
+    }
+
+    // Median displacement is robust to the few points that slid onto the background
+    std::nth_element(m_dx.begin(), m_dx.begin() + m_dx.size() / 2, m_dx.end());
+    std::nth_element(m_dy.begin(), m_dy.begin() + m_dy.size() / 2, m_dy.end());
+    Point2f shift(m_dx[m_dx.size() / 2], m_dy[m_dy.size() / 2]);
+
+    m_position += shift;
+    m_rect = Rect(cvRound(m_rect.x + shift.x), cvRound(m_rect.y + shift.y), m_rect.width, m_rect.height) &
+             Rect(Point(0, 0), current.size);
+    m_points.swap(m_kept);
+    m_frame = current.frame;
+
+    if (m_rect.empty())
+    {
+        reset();
+        return false;
+    }
+    return true;
+}
+
+void OpticalFlowTracker::reset()
+{
+    m_points.clear();
+    m_seedCount = 0;
+    m_confidence = 0.0;
+    m_active = false;
+}
@@ -0,0 +1,121 @@
+#ifndef OPTICALFLOWTRACKER_H
+#define OPTICALFLOWTRACKER_H
+
+#include "opencv2/opencv.hpp"
+#include <QtGlobal>
+#include <vector>
+
+using namespace cv;
+
+/**
+ * @brief Image pyramid of one grayscale frame for the Lucas-Kanade flow
+ *
+ * Built once per frame and shared by all the trackers, so following a second hand
+ * does not build the pyramids of the previous and current frames again.
+ */
+struct FlowPyramid
+{
+    std::vector<Mat> levels; // Levels built by buildOpticalFlowPyramid(), buffers reused between frames
+    Size size;               // Size of the frame
+    quint64 frame = 0;       // Index of the frame the pyramid was built from (0 = none)
+
+    /**
+     * @brief Builds the pyramid of a frame
+     * @param gray Grayscale frame
+     * @param frameIndex Index of the frame, increasing with each processed frame
+     */
+    void build(const Mat &gray, quint64 frameIndex);
+
+    static const int WINDOW_SIZE = 21; // Search window of the flow at each level (pixels)
+    static const int MAX_LEVEL = 3;    // Index of the coarsest level
+};
+
+/**
+ * @brief Sparse Lucas-Kanade optical flow tracker for the hand region
+ *
+ * Seeded with corners found inside a detection, the tracker follows these points
+ * from frame to frame and moves the hand position and region by their median
+ * displacement. A forward-backward check rejects unreliable points; the share of
+ * seeded points still tracked is reported as the confidence.
+ */
+class OpticalFlowTracker
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    OpticalFlowTracker();
+
+    /**
+     * @brief Starts tracking from a detection
+     * @param pyramid Pyramid of the frame the detection was made on
+     * @param gray Grayscale frame the pyramid was built from
+     * @param roi Detected hand region (clipped to the frame)
+     * @param position Tracked hand position in frame coordinates
+     * @return true if enough points were found to track
+     */
+    bool seed(const FlowPyramid &pyramid, const Mat &gray, const Rect &roi, const Point2f &position);
+
+    /**
+     * @brief Follows the points into a new frame
+     * @param previous Pyramid of the frame the tracker was last seeded or updated on
+     * @param current Pyramid of the following frame
+     * @return true if the hand is still tracked, false if lost or if a frame was skipped
+     */
+    bool update(const FlowPyramid &previous, const FlowPyramid &current);
+
+    /**
+     * @brief Stops tracking until the next seed
+     */
+    void reset();
+
+    /**
+     * @brief Check if the tracker currently follows a hand
+     * @return true if seeded and not lost
+     */
+    bool isActive() const { return m_active; }
+
+    /**
+     * @brief Get the share of seeded points that are still tracked
+     * @return Confidence between 0 and 1
+     */
+    double confidence() const { return m_confidence; }
+
+    /**
+     * @brief Get the tracked hand position
+     * @return Position in frame coordinates
+     */
+    Point2f position() const { return m_position; }
+
+    /**
+     * @brief Get the tracked hand region
+     * @return Detection region moved along with the hand
+     */
+    Rect trackedRect() const { return m_rect; }
+
+    /**
+     * @brief Get the points currently tracked
+     * @return Points in frame coordinates
+     */
+    const std::vector<Point2f> &points() const { return m_points; }
+
+private:
+    quint64 m_frame;               // Index of the frame the points were found or tracked on
+    std::vector<Point2f> m_points; // Points tracked in the previous frame
+
+    // Work buffers of update(), kept between frames to reuse their capacity
+    std::vector<Point2f> m_nextPoints, m_backPoints, m_kept;
+    std::vector<uchar> m_status, m_backStatus;
+    std::vector<float> m_error, m_backError, m_dx, m_dy;
+    size_t m_seedCount;            // Number of points at the last seed
+    Point2f m_position;            // Tracked hand position
+    Rect m_rect;                   // Tracked hand region
+    double m_confidence;           // Share of seeded points still tracked
+    bool m_active;                 // Flag indicating if a hand is tracked
+
+    static const int MAX_POINTS = 40;           // Maximum number of corners seeded in the region
+    static const int MIN_POINTS = 6;            // Minimum number of points to keep tracking
+    static constexpr float MAX_FB_ERROR = 1.5f; // Maximum forward-backward error (pixels)
+};
+
+#endif // OPTICALFLOWTRACKER_H
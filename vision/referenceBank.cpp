@@ -0,0 +1,196 @@
+#include "referenceBank.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+
+ReferenceBank::ReferenceBank(QThreadPool *pool)
+    : m_pool(pool),
+      m_backend(HandTracker::Sift),
+      m_ratioThreshold(0.0f),
+      m_capacity(1),
+      m_active(0),
+      m_step(0),
+      m_lastCostMs(0.0),
+      m_hasPending(false)
+{
+}
+
+ReferenceBank::~ReferenceBank()
+{
+    clear();
+}
+
+void ReferenceBank::configure(HandTracker::Backend backend, float ratioThreshold, int capacity)
+{
+    bool rebuild = backend != m_backend || ratioThreshold != m_ratioThreshold;
+    m_backend = backend;
+    m_ratioThreshold = ratioThreshold;
+    m_capacity = std::max(1, capacity);
+
+    // A keyframe prepared for the previous backend cannot be merged
+    if (rebuild)
+    {
+        discardPending();
+    }
+
+    // Least recently matched keyframes go first when the bank shrinks, the reference stays
+    while (size() > m_capacity)
+    {
+        auto oldest = std::min_element(m_keyframes.begin() + 1, m_keyframes.end(), [](const Keyframe &a, const Keyframe &b)
+                                       { return a.lastMatched < b.lastMatched; });
+        delete oldest->tracker;
+        m_keyframes.erase(oldest);
+    }
+    m_active = std::max(0, std::min(m_active, size() - 1));
+
+    if (rebuild)
+    {
+        for (Keyframe &keyframe : m_keyframes)
+        {
+            delete keyframe.tracker;
+            keyframe.tracker = HandTracker::create(m_backend, m_ratioThreshold);
+            keyframe.tracker->setReference(keyframe.image);
+        }
+    }
+}
+
+void ReferenceBank::clear()
+{
+    discardPending();
+    for (Keyframe &keyframe : m_keyframes)
+    {
+        delete keyframe.tracker;
+    }
+    m_keyframes.clear();
+    m_active = 0;
+}
+
+bool ReferenceBank::setReference(const Mat &reference)
+{
+    clear();
+
+    Keyframe keyframe;
+    keyframe.image = reference;
+    keyframe.tracker = HandTracker::create(m_backend, m_ratioThreshold);
+    keyframe.lastMatched = m_step;
+    bool trackable = keyframe.tracker->setReference(reference);
+    m_keyframes.push_back(keyframe);
+    return trackable;
+}
+
+bool ReferenceBank::addKeyframe(const Mat &keyframe)
+{
+    collectPending();
+    if (m_hasPending || m_capacity < 2 || m_keyframes.empty())
+    {
+        return false;
+    }
+
+    // The features of the keyframe are computed on the pool, the vision thread goes on meanwhile
+    m_pendingImage = keyframe.clone();
+    HandTracker::Backend backend = m_backend;
+    float ratioThreshold = m_ratioThreshold;
+    Mat image = m_pendingImage;
+    m_pending = QtConcurrent::run(m_pool, [backend, ratioThreshold, image]() -> HandTracker *
+                                  {
+        HandTracker *tracker = HandTracker::create(backend, ratioThreshold);
+        if (!tracker->setReference(image))
+        {
+            delete tracker;
+            return nullptr;
+        }
+        return tracker; });
+    m_hasPending = true;
+    return true;
+}
+
+void ReferenceBank::collectPending()
+{
+    if (!m_hasPending || !m_pending.isFinished())
+    {
+        return;
+    }
+
+    m_hasPending = false;
+    HandTracker *tracker = m_pending.result();
+    if (!tracker || m_keyframes.empty())
+    {
+        delete tracker;
+        return;
+    }
+
+    Keyframe keyframe;
+    keyframe.image = m_pendingImage;
+    keyframe.tracker = tracker;
+    keyframe.lastMatched = m_step;
+
+    // A full bank replaces its least recently matched keyframe, never the captured reference
+    if (size() < m_capacity)
+    {
+        m_keyframes.push_back(keyframe);
+        return;
+    }
+    auto oldest = std::min_element(m_keyframes.begin() + 1, m_keyframes.end(), [](const Keyframe &a, const Keyframe &b)
+                                   { return a.lastMatched < b.lastMatched; });
+    delete oldest->tracker;
+    *oldest = keyframe;
+}
+
+void ReferenceBank::discardPending()
+{
+    if (!m_hasPending)
+    {
+        return;
+    }
+
+    m_pending.waitForFinished();
+    delete m_pending.result();
+    m_hasPending = false;
+    m_pendingImage.release();
+}
+
+TrackResult ReferenceBank::track(const Mat &frame, const Rect &roi)
+{
+    collectPending();
+    m_step++;
+
+    if (m_keyframes.empty())
+    {
+        m_lastCostMs = 0.0;
+        return TrackResult();
+    }
+
+    // Usually the active keyframe matches well enough and is the only one tried.
+    // The features of the region are described by the first tracker and reused by the others.
+    m_roiFeatures.described = false;
+    TrackResult best = m_keyframes[m_active].tracker->track(frame, roi, m_roiFeatures);
+    double costMs = best.costMs, describeMs = best.describeMs, matchMs = best.matchMs;
+    int bestIndex = m_active;
+    if (best.matchQuality < SWITCH_QUALITY)
+    {
+        for (int i = 0; i < size(); i++)
+        {
+            if (i == m_active)
+            {
+                continue;
+            }
+
+            TrackResult result = m_keyframes[i].tracker->track(frame, roi, m_roiFeatures);
+            costMs += result.costMs;
+            describeMs += result.describeMs;
+            matchMs += result.matchMs;
+            if (result.matchQuality > best.matchQuality)
+            {
+                best = result;
+                bestIndex = i;
+            }
+        }
+    }
+
+    m_active = bestIndex;
+    m_keyframes[m_active].lastMatched = m_step;
+    best.costMs = costMs;
+    best.describeMs = describeMs;
+    best.matchMs = matchMs;
+    m_lastCostMs = costMs;
+    return best;
+}
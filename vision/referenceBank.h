@@ -0,0 +1,146 @@
+#ifndef REFERENCEBANK_H
+#define REFERENCEBANK_H
+
+#include "opencv2/opencv.hpp"
+#include <QFuture>
+#include <QThreadPool>
+#include <vector>
+#include "handTracker.h"
+
+using namespace cv;
+
+/**
+ * @brief Bounded set of reference keyframes of the hand, each with its own tracker
+ *
+ * The first keyframe is the captured reference and is always kept. Further keyframes
+ * show the hand in other poses or lighting; their trackers (and so their descriptors)
+ * are built on a pool thread and merged on a later frame, so adding a keyframe never
+ * stalls the vision thread. When the bank is full, the keyframe matched least recently
+ * is replaced.
+ *
+ * Frames are tracked with the keyframe that matched last; the other keyframes are only
+ * tried when that match is poor, and the best one becomes the active keyframe.
+ * Only used from the vision thread.
+ */
+class ReferenceBank
+{
+public:
+    /**
+     * @brief Constructor
+     * @param pool Pool running the keyframe preparations, not owned
+     */
+    explicit ReferenceBank(QThreadPool *pool);
+
+    /**
+     * @brief Destructor waits for a keyframe still being prepared and releases the trackers
+     */
+    ~ReferenceBank();
+
+    /**
+     * @brief Selects the tracker backend and the size of the bank
+     * @param backend Tracker backend of the keyframes
+     * @param ratioThreshold Lowe ratio test threshold, 0 for the default of the backend
+     * @param capacity Maximum number of keyframes, at least 1
+     *
+     * Changing the backend or the ratio rebuilds the trackers of the kept keyframes.
+     */
+    void configure(HandTracker::Backend backend, float ratioThreshold, int capacity);
+
+    /**
+     * @brief Removes all the keyframes
+     */
+    void clear();
+
+    /**
+     * @brief Replaces the bank by a single captured reference
+     * @param reference Reference image (BGR), prepared on the calling thread
+     * @return true if the reference can be tracked
+     */
+    bool setReference(const Mat &reference);
+
+    /**
+     * @brief Prepares a new keyframe in the background
+     * @param keyframe Keyframe image (BGR), copied
+     * @return false if a keyframe is already being prepared or the bank holds a single reference
+     */
+    bool addKeyframe(const Mat &keyframe);
+
+    /**
+     * @brief Locates the hand with the active keyframe, or the best one when its match is poor
+     * @param frame Current frame (BGR or grayscale)
+     * @param roi Region of interest, already clipped to the frame
+     * @return Result of the best keyframe, with the cost of all the keyframes tried
+     *
+     * The region is described once, every keyframe tried only matches its descriptors.
+     */
+    TrackResult track(const Mat &frame, const Rect &roi);
+
+    /**
+     * @brief Get the number of keyframes
+     * @return Keyframes ready to be matched
+     */
+    int size() const { return static_cast<int>(m_keyframes.size()); }
+
+    /**
+     * @brief Get the maximum number of keyframes
+     * @return Capacity of the bank
+     */
+    int capacity() const { return m_capacity; }
+
+    /**
+     * @brief Get the keyframe that matched last
+     * @return Index of the active keyframe (0 = captured reference)
+     */
+    int activeKeyframe() const { return m_active; }
+
+    /**
+     * @brief Get the tracker backend of the keyframes
+     * @return Backend identifier
+     */
+    HandTracker::Backend backend() const { return m_backend; }
+
+    /**
+     * @brief Get the cost of the last tracking step
+     * @return Time spent in the last call to track(), over all the keyframes tried (milliseconds)
+     */
+    double lastCostMs() const { return m_lastCostMs; }
+
+private:
+    /**
+     * @brief One reference image of the hand
+     */
+    struct Keyframe
+    {
+        Mat image;                     // Reference image (BGR)
+        HandTracker *tracker = nullptr; // Tracker holding the precomputed features of the image
+        quint64 lastMatched = 0;       // Tracking step where the keyframe was last the best match
+    };
+
+    /**
+     * @brief Merges the keyframe prepared in the background, once it is ready
+     */
+    void collectPending();
+
+    /**
+     * @brief Waits for the keyframe being prepared and drops it
+     */
+    void discardPending();
+
+    QThreadPool *m_pool;              // Pool running the keyframe preparations (not owned)
+    HandTracker::Backend m_backend;   // Tracker backend of the keyframes
+    float m_ratioThreshold;           // Ratio test threshold of the keyframe trackers
+    int m_capacity;                   // Maximum number of keyframes
+    std::vector<Keyframe> m_keyframes; // Keyframes, the captured reference first
+    int m_active;                     // Index of the keyframe that matched last
+    quint64 m_step;                   // Number of tracking steps, orders the keyframe uses
+    double m_lastCostMs;              // Cost of the last tracking step
+    RoiFeatures m_roiFeatures;        // Features of the region of interest, described once per step for all the keyframes
+
+    QFuture<HandTracker *> m_pending; // Tracker of the keyframe being prepared
+    Mat m_pendingImage;               // Image of the keyframe being prepared
+    bool m_hasPending;                // Flag indicating if a keyframe is being prepared
+
+    static const int SWITCH_QUALITY = 10; // Match quality of the active keyframe below which the others are tried
+};
+
+#endif // REFERENCEBANK_H
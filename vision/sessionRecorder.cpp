@@ -0,0 +1,148 @@
+#include "sessionRecorder.h"
+#include <QDir>
+
+SessionRecorder::SessionRecorder(QObject *parent)
+    : QThread(parent),
+      m_head(0),
+      m_count(0),
+      m_stopRequested(false),
+      m_recording(false),
+      m_framesWritten(0),
+      m_framesDropped(0)
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+}
+
+bool SessionRecorder::start(const QString &directory, const Size &frameSize, double frameRate, QString &error)
+{
+    stop();
+
+    if (!QDir().mkpath(directory))
+    {
+        error = QString("Cannot create %1").arg(directory);
+        return false;
+    }
+
+    // Motion JPEG compresses each frame on its own: cheap to encode and every frame can be replayed alone
+    QString videoPath = QDir(directory).filePath("session.avi");
+    if (!m_video.open(videoPath.toStdString(), VideoWriter::fourcc('M', 'J', 'P', 'G'),
+                      frameRate > 0.0 ? frameRate : 30.0, frameSize))
+    {
+        error = QString("Cannot open %1 for writing").arg(videoPath);
+        return false;
+    }
+
+    m_csvFile.setFileName(QDir(directory).filePath("frames.csv"));
+    if (!m_csvFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        error = QString("Cannot open %1 for writing").arg(m_csvFile.fileName());
+        m_video.release();
+        return false;
+    }
+    m_csv.setDevice(&m_csvFile);
+    m_csv << "sequence,timestamp_ns,x,y,confidence,match_quality,valid,rect_x,rect_y,rect_width,rect_height,tracking,"
+             "second_x,second_y,second_confidence,second_valid\n";
+
+    m_directory = directory;
+    m_frameSize = frameSize;
+    m_head = 0;
+    m_count = 0;
+    m_stopRequested = false;
+    m_framesWritten.store(0, std::memory_order_relaxed);
+    m_framesDropped.store(0, std::memory_order_relaxed);
+    m_recording.store(true, std::memory_order_release);
+    QThread::start(QThread::LowPriority);
+    return true;
+}
+
+void SessionRecorder::stop()
+{
+    if (!isRecording())
+    {
+        return;
+    }
+
+    // No frame is accepted anymore, the writer empties the queue and exits
+    {
+        QMutexLocker locker(&m_mutex);
+        m_recording.store(false, std::memory_order_release);
+        m_stopRequested = true;
+        m_queued.wakeOne();
+    }
+    wait();
+
+    m_video.release();
+    m_csv.flush();
+    m_csv.setDevice(nullptr);
+    m_csvFile.close();
+}
+
+bool SessionRecorder::push(const Mat &frame, const RecordedFrame &outputs)
+{
+    if (!isRecording() || frame.size() != m_frameSize)
+    {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_recording.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+    if (m_count == QUEUE_CAPACITY)
+    {
+        m_framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // The slot buffer already has the frame size after the first lap, the copy does not allocate
+    Slot &slot = m_slots[(m_head + m_count) % QUEUE_CAPACITY];
+    frame.copyTo(slot.frame);
+    slot.outputs = outputs;
+    m_count++;
+    m_queued.wakeOne();
+    return true;
+}
+
+void SessionRecorder::run()
+{
+    forever
+    {
+        // The oldest slot is not touched by push() until it is released below
+        Slot *slot = nullptr;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_count == 0 && !m_stopRequested)
+            {
+                m_queued.wait(&m_mutex);
+            }
+            if (m_count == 0)
+            {
+                return;
+            }
+            slot = &m_slots[m_head];
+        }
+
+        // Encoding and disk writes happen outside the lock
+        m_video.write(slot->frame);
+        const RecordedFrame &outputs = slot->outputs;
+        const HandSample &first = outputs.hands[0];
+        const HandSample &second = outputs.hands[1];
+        m_csv << first.sequence << ',' << first.timestampNs << ','
+              << first.x << ',' << first.y << ',' << first.confidence << ',' << first.matchQuality << ','
+              << (first.valid ? 1 : 0) << ','
+              << outputs.handRect.x << ',' << outputs.handRect.y << ','
+              << outputs.handRect.width << ',' << outputs.handRect.height << ','
+              << (outputs.tracking ? 1 : 0) << ','
+              << second.x << ',' << second.y << ',' << second.confidence << ',' << (second.valid ? 1 : 0) << '\n';
+        m_framesWritten.fetch_add(1, std::memory_order_relaxed);
+
+        QMutexLocker locker(&m_mutex);
+        m_head = (m_head + 1) % QUEUE_CAPACITY;
+        m_count--;
+    }
+}
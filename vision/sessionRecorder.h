@@ -0,0 +1,137 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include "opencv2/opencv.hpp"
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QTextStream>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include "handSample.h"
+
+using namespace cv;
+
+/**
+ * @brief Tracker outputs stored with each recorded frame
+ */
+struct RecordedFrame
+{
+    HandSample hands[2]; // Samples published for the first and the second hand
+    Rect handRect;       // Region of the first hand found on the frame (mirrored coordinates, empty if not found)
+    bool tracking = false; // Flag indicating if the pipeline tracked the hand against its reference
+};
+
+/**
+ * @brief Records camera sessions to disk on a background writer thread
+ *
+ * The raw frames (as read from the source, before mirroring) are compressed to a
+ * Motion JPEG AVI file, which VideoFileFrameSource and CameraHandler::openReplay()
+ * can play back. A CSV file next to it holds, for every frame, the capture timestamp
+ * and the outputs of the tracker.
+ *
+ * push() is called by the vision thread: it only copies the frame into a slot of a
+ * bounded queue, whose buffers are reused, and never waits for the disk. When the
+ * writer falls behind and the queue is full, the frame is dropped and counted.
+ * start() and stop() are called from the GUI thread.
+ */
+class SessionRecorder : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param parent Parent QObject
+     */
+    explicit SessionRecorder(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor stops the recording
+     */
+    ~SessionRecorder();
+
+    /**
+     * @brief Opens the files of a new session and starts the writer thread
+     * @param directory Directory receiving session.avi and frames.csv, created if needed
+     * @param frameSize Size of the recorded frames
+     * @param frameRate Frame rate written in the video header
+     * @param error Receives the reason of a failure
+     * @return true if the recording started
+     */
+    bool start(const QString &directory, const Size &frameSize, double frameRate, QString &error);
+
+    /**
+     * @brief Writes the queued frames, closes the files and stops the writer thread
+     */
+    void stop();
+
+    /**
+     * @brief Check if a session is being recorded
+     * @return true between start() and stop()
+     */
+    bool isRecording() const { return m_recording.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Queues a frame for writing, without waiting for the disk
+     * @param frame Raw frame read from the source, copied
+     * @param outputs Tracker outputs of the frame
+     * @return false if the frame was dropped (not recording, queue full or different size)
+     */
+    bool push(const Mat &frame, const RecordedFrame &outputs);
+
+    /**
+     * @brief Get the number of frames written since start()
+     * @return Written frames
+     */
+    quint64 framesWritten() const { return m_framesWritten.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of frames dropped since start()
+     * @return Frames dropped because the queue was full
+     */
+    quint64 framesDropped() const { return m_framesDropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the directory of the current or last session
+     * @return Session directory
+     */
+    QString directory() const { return m_directory; }
+
+protected:
+    /**
+     * @brief Writer loop: encodes the queued frames until stop() and the queue is empty
+     */
+    void run() override;
+
+private:
+    /**
+     * @brief One queued frame
+     */
+    struct Slot
+    {
+        Mat frame;             // Copy of the raw frame, buffer reused between sessions
+        RecordedFrame outputs; // Tracker outputs of the frame
+    };
+
+    static const int QUEUE_CAPACITY = 16; // Frames waiting for the writer (about half a second at 30 Hz)
+
+    Slot m_slots[QUEUE_CAPACITY]; // Ring of queued frames
+    int m_head;                   // Index of the oldest queued frame
+    int m_count;                  // Number of queued frames
+    bool m_stopRequested;         // Flag asking the writer to finish the queue and stop
+    QMutex m_mutex;               // Protects the ring, m_count and m_stopRequested
+    QWaitCondition m_queued;      // Wakes the writer when a frame is queued or stop() is called
+
+    Size m_frameSize;             // Size of the recorded frames
+    QString m_directory;          // Directory of the session
+    VideoWriter m_video;          // Motion JPEG writer, only used by the writer thread while recording
+    QFile m_csvFile;              // Per-frame timestamps and tracker outputs
+    QTextStream m_csv;            // Text stream on m_csvFile
+    std::atomic<bool> m_recording; // Flag indicating if push() accepts frames
+    std::atomic<quint64> m_framesWritten; // Frames written since start()
+    std::atomic<quint64> m_framesDropped; // Frames dropped since start()
+};
+
+#endif // SESSIONRECORDER_H
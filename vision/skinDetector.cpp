@@ -0,0 +1,66 @@
+#include "skinDetector.h"
+#include <algorithm>
+
+SkinDetector::SkinDetector()
+    : m_lower(0, 133, 77),
+      m_upper(255, 173, 127)
+{
+    // Removes the isolated pixels and thin structures left by the threshold
+    m_kernel = getStructuringElement(MORPH_ELLIPSE, Size(5, 5));
+}
+
+void SkinDetector::setRange(const Scalar &lower, const Scalar &upper)
+{
+    m_lower = lower;
+    m_upper = upper;
+}
+
+Rect SkinDetector::detect(const Mat &image, const Rect &window, int minSize)
+{
+    return detect(image, window, minSize, m_blobs, 1) > 0 ? m_blobs[0] : Rect();
+}
+
+int SkinDetector::detect(const Mat &image, const Rect &window, int minSize, std::vector<Rect> &blobs, int maxCount)
+{
+    blobs.clear();
+    Rect searched = window & Rect(0, 0, image.cols, image.rows);
+    if (image.empty() || searched.empty() || maxCount <= 0)
+    {
+        return 0;
+    }
+
+    // The pooled buffers are sized for the whole frame, the window uses a view of them
+    m_ycrcbPool.create(image.size(), CV_8UC3);
+    m_maskPool.create(image.size(), CV_8UC1);
+    Mat ycrcb = m_ycrcbPool(Rect(Point(0, 0), searched.size()));
+    m_mask = m_maskPool(Rect(Point(0, 0), searched.size()));
+
+    // Chroma thresholding is mostly independent of the brightness, Y is left fully open by default
+    cvtColor(image(searched), ycrcb, COLOR_BGR2YCrCb);
+    inRange(ycrcb, m_lower, m_upper, m_mask);
+    morphologyEx(m_mask, m_mask, MORPH_OPEN, m_kernel);
+
+    m_contours.clear();
+    findContours(m_mask, m_contours, RETR_EXTERNAL, CHAIN_APPROX_SIMPLE);
+
+    // Keep the largest blobs that are big enough to be a hand
+    m_areas.clear();
+    for (size_t i = 0; i < m_contours.size(); i++)
+    {
+        Rect blob = boundingRect(m_contours[i]);
+        if (blob.width >= minSize && blob.height >= minSize)
+        {
+            m_areas.push_back(std::make_pair(contourArea(m_contours[i]), static_cast<int>(i)));
+        }
+    }
+
+    int count = std::min(maxCount, static_cast<int>(m_areas.size()));
+    std::partial_sort(m_areas.begin(), m_areas.begin() + count, m_areas.end(),
+                      [](const std::pair<double, int> &a, const std::pair<double, int> &b)
+                      { return a.first > b.first; });
+    for (int i = 0; i < count; i++)
+    {
+        blobs.push_back(boundingRect(m_contours[m_areas[i].second]) + searched.tl());
+    }
+    return count;
+}
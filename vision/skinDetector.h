@@ -0,0 +1,74 @@
+#ifndef SKINDETECTOR_H
+#define SKINDETECTOR_H
+
+#include "opencv2/opencv.hpp"
+#include <vector>
+
+using namespace cv;
+
+/**
+ * @brief Hand detector based on skin colour segmentation
+ *
+ * A fast alternative to the Haar cascades: the search region is converted to YCrCb,
+ * thresholded on the chroma channels, cleaned up with a morphological opening, and
+ * the bounding box of the largest blob is returned. All the steps are vectorized
+ * OpenCV kernels working on pooled buffers, so a full frame costs well under a millisecond.
+ *
+ * Any skin coloured region can be picked (the face in particular) until the search
+ * window is locked on the hand.
+ */
+class SkinDetector
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    SkinDetector();
+
+    /**
+     * @brief Changes the chroma range considered as skin
+     * @param lower Lower bound (Y, Cr, Cb)
+     * @param upper Upper bound (Y, Cr, Cb)
+     */
+    void setRange(const Scalar &lower, const Scalar &upper);
+
+    /**
+     * @brief Finds the largest skin coloured blob
+     * @param image BGR frame
+     * @param window Region of the frame to search
+     * @param minSize Minimum width and height of the blob in pixels
+     * @return Bounding box of the blob in frame coordinates (empty if no detection)
+     */
+    Rect detect(const Mat &image, const Rect &window, int minSize);
+
+    /**
+     * @brief Finds the largest skin coloured blobs
+     * @param image BGR frame
+     * @param window Region of the frame to search
+     * @param minSize Minimum width and height of a blob in pixels
+     * @param blobs Receives the bounding boxes in frame coordinates, largest first
+     * @param maxCount Maximum number of blobs returned
+     * @return Number of blobs found
+     */
+    int detect(const Mat &image, const Rect &window, int minSize, std::vector<Rect> &blobs, int maxCount);
+
+    /**
+     * @brief Get the skin mask of the last search window
+     * @return Binary mask after the morphological opening (for debugging)
+     */
+    const Mat &mask() const { return m_mask; }
+
+private:
+    Scalar m_lower; // Lower YCrCb bound of the skin colour
+    Scalar m_upper; // Upper YCrCb bound of the skin colour
+    Mat m_kernel;   // Structuring element of the opening
+
+    Mat m_ycrcbPool; // Search window converted to YCrCb, sized for the whole frame
+    Mat m_maskPool;  // Skin mask, sized for the whole frame
+    Mat m_mask;      // View of the mask pool covering the last search window
+    std::vector<std::vector<Point>> m_contours; // Blobs of the mask, reused between frames
+    std::vector<std::pair<double, int>> m_areas; // Area and index of the blobs large enough, reused between frames
+    std::vector<Rect> m_blobs; // Result of the single blob detection, reused between frames
+};
+
+#endif // SKINDETECTOR_H
@@ -0,0 +1,254 @@
+#include "syntheticFrameSource.h"
+#include <algorithm>
+#include <cmath>
+
+SyntheticFrameSource::SyntheticFrameSource(const Size &size, double frameRate, Pacing pacing)
+    : FrameSource(pacing),
+      m_size(size),
+      m_frameRate(frameRate > 0.0 ? frameRate : 30.0),
+      m_opened(true),
+      m_frameIndex(0)
+{
+}
+
+void SyntheticFrameSource::setScene(const Scene &scene)
+{
+    m_scene = scene;
+    m_scene.pathPeriod = scene.pathPeriod > 0.0 ? scene.pathPeriod : 2.0;
+    m_scene.lightingPeriod = scene.lightingPeriod > 0.0 ? scene.lightingPeriod : 4.0;
+
+    // Templates without a mask keep their non-black pixels
+    if (!m_scene.handTemplate.empty() && m_scene.handMask.empty())
+    {
+        Mat gray;
+        cvtColor(m_scene.handTemplate, gray, COLOR_BGR2GRAY);
+        threshold(gray, m_scene.handMask, 10, 255, THRESH_BINARY);
+    }
+    m_scaledTemplate.release();
+    m_scaledMask.release();
+
+    // The background is prepared at the frame size once
+    m_background.release();
+    if (!m_scene.background.empty())
+    {
+        resize(m_scene.background, m_background, m_size, 0.0, 0.0, INTER_AREA);
+    }
+    else if (m_scene.texturedBackground)
+    {
+        m_background = createBackground();
+    }
+
+    // A few noise frames cycled through look like sensor noise to the pipeline
+    m_noise.clear();
+    if (m_scene.noiseSigma > 0.0)
+    {
+        RNG rng(m_scene.seed + 1);
+        for (int i = 0; i < NOISE_FRAMES; i++)
+        {
+            Mat noise(m_size, CV_8SC3);
+            rng.fill(noise, RNG::NORMAL, Scalar::all(0.0), Scalar::all(m_scene.noiseSigma));
+            m_noise.push_back(noise);
+        }
+    }
+}
+
+Mat SyntheticFrameSource::createHandTemplate(int height, Mat &mask)
+{
+    height = std::max(height, 16);
+    int width = height * 3 / 4;
+    Mat hand(height, width, CV_8UC3, Scalar::all(0));
+    mask = Mat::zeros(height, width, CV_8UC1);
+
+    // Palm, four fingers and the thumb, with the round caps of thick lines as finger tips
+    int fingerWidth = std::max(3, width * 13 / 100);
+    Point palmCenter(width / 2, height * 65 / 100);
+    ellipse(mask, palmCenter, Size(width * 32 / 100, height * 28 / 100), 0.0, 0.0, 360.0, Scalar(255), FILLED);
+    const float fingerX[4] = {0.30f, 0.45f, 0.60f, 0.75f};
+    const float fingerTop[4] = {0.14f, 0.06f, 0.08f, 0.17f};
+    for (int i = 0; i < 4; i++)
+    {
+        line(mask, Point(cvRound(width * fingerX[i]), height / 2),
+             Point(cvRound(width * fingerX[i]), cvRound(height * fingerTop[i])), Scalar(255), fingerWidth);
+    }
+    line(mask, Point(width * 25 / 100, height * 72 / 100), Point(width * 8 / 100, height * 45 / 100),
+         Scalar(255), fingerWidth);
+    hand.setTo(Scalar(120, 160, 220), mask);
+
+    // Lighter middle of the palm and darker creases give the trackers corners to follow
+    Mat highlight = Mat::zeros(height, width, CV_8UC1);
+    ellipse(highlight, palmCenter, Size(width * 18 / 100, height * 15 / 100), 0.0, 0.0, 360.0, Scalar(255), FILLED);
+    hand.setTo(Scalar(138, 178, 236), highlight & mask);
+
+    Scalar crease(84, 112, 160);
+    int creaseWidth = std::max(1, height / 80);
+    for (int i = 0; i < 4; i++)
+    {
+        int x = cvRound(width * fingerX[i]);
+        int top = cvRound(height * fingerTop[i]);
+        for (int joint = 1; joint <= 2; joint++)
+        {
+            int y = top + (height / 2 - top) * joint / 3;
+            line(hand, Point(x - fingerWidth / 3, y), Point(x + fingerWidth / 3, y), crease, creaseWidth);
+        }
+    }
+    ellipse(hand, Point(width / 2, height * 55 / 100), Size(width * 22 / 100, height * 8 / 100), 10.0, 0.0, 180.0,
+            crease, creaseWidth);
+    ellipse(hand, Point(width * 45 / 100, height * 72 / 100), Size(width * 20 / 100, height * 12 / 100), -30.0, 180.0,
+            300.0, crease, creaseWidth);
+
+    // The creases must not spill outside the hand
+    Mat background;
+    bitwise_not(mask, background);
+    hand.setTo(Scalar::all(0), background);
+    return hand;
+}
+
+Mat SyntheticFrameSource::createBackground() const
+{
+    RNG rng(m_scene.seed);
+
+    // Blocks of grey, blue and green: red never exceeds the other channels,
+    // so the chroma stays below the skin range whatever the lighting
+    Size cells(std::max(1, m_size.width / 40), std::max(1, m_size.height / 40));
+    Mat blocks(cells, CV_8UC3);
+    for (int y = 0; y < cells.height; y++)
+    {
+        for (int x = 0; x < cells.width; x++)
+        {
+            int value = rng.uniform(30, 170);
+            switch (rng.uniform(0, 3))
+            {
+            case 0:
+                blocks.at<Vec3b>(y, x) = Vec3b(value, value, value);
+                break;
+            case 1:
+                blocks.at<Vec3b>(y, x) = Vec3b(saturate_cast<uchar>(value + 40), saturate_cast<uchar>(value + 10), value);
+                break;
+            default:
+                blocks.at<Vec3b>(y, x) = Vec3b(value, saturate_cast<uchar>(value + 30), value);
+                break;
+            }
+        }
+    }
+    Mat background;
+    resize(blocks, background, m_size, 0.0, 0.0, INTER_NEAREST);
+
+    // Smoothed grain, the same on every channel to keep the chroma neutral
+    Mat grain(m_size, CV_8SC1);
+    rng.fill(grain, RNG::NORMAL, Scalar(0.0), Scalar(12.0));
+    GaussianBlur(grain, grain, Size(3, 3), 0.0);
+    Mat grain3;
+    Mat channels[3] = {grain, grain, grain};
+    merge(channels, 3, grain3);
+    add(background, grain3, background, noArray(), CV_8U);
+    return background;
+}
+
+Size SyntheticFrameSource::handSize(qint64 frameIndex) const
+{
+    // The size oscillates out of step with the path, so every size is seen at every place
+    double t = frameIndex / m_frameRate;
+    double scale = m_scene.handScale * (1.0 + m_scene.scaleVariation * std::sin(2.0 * CV_PI * t / (1.5 * m_scene.pathPeriod)));
+    int height = std::max(8, cvRound(m_size.height / 4.0 * scale));
+
+    if (m_scene.handTemplate.empty())
+    {
+        // Blob of the measurement scene, as wide as a seventh of the frame at scale 1
+        return Size(std::max(8, cvRound(m_size.width / 7.0 * scale)), height);
+    }
+    return Size(std::max(4, height * m_scene.handTemplate.cols / m_scene.handTemplate.rows), height);
+}
+
+Point2f SyntheticFrameSource::handPosition(qint64 frameIndex) const
+{
+    // Scripted time (not wall time) so that every run sees the same motion
+    double t = frameIndex / m_frameRate;
+    double cycle = t / m_scene.pathPeriod;
+
+    if (m_scene.path.empty())
+    {
+        // Lissajous path covering the middle of the frame
+        double phase = 2.0 * CV_PI * cycle;
+        float x = static_cast<float>(m_size.width * (0.5 + 0.3 * std::sin(phase)));
+        float y = static_cast<float>(m_size.height * (0.5 + 0.2 * std::sin(2.0 * phase)));
+        return Point2f(x, y);
+    }
+
+    // Constant time per segment of the looped waypoints
+    int count = static_cast<int>(m_scene.path.size());
+    double position = (cycle - std::floor(cycle)) * count;
+    int segment = std::min(count - 1, static_cast<int>(position));
+    float ratio = static_cast<float>(position - segment);
+    const Point2f &from = m_scene.path[segment];
+    const Point2f &to = m_scene.path[(segment + 1) % count];
+    Point2f normalized = from + (to - from) * ratio;
+    return Point2f(normalized.x * m_size.width, normalized.y * m_size.height);
+}
+
+Rect SyntheticFrameSource::handRect(qint64 frameIndex) const
+{
+    Point2f center = handPosition(frameIndex);
+    Size size = handSize(frameIndex);
+    Rect rect(cvRound(center.x - size.width / 2.0f), cvRound(center.y - size.height / 2.0f), size.width, size.height);
+    return rect & Rect(Point(0, 0), m_size);
+}
+
+bool SyntheticFrameSource::readFrame(Mat &frame)
+{
+    if (!m_opened)
+    {
+        return false;
+    }
+
+    // Dark gray background (neutral chroma, never taken for skin) unless a texture was prepared
+    if (m_background.empty())
+    {
+        frame.create(m_size, CV_8UC3);
+        frame.setTo(Scalar(40, 40, 40));
+    }
+    else
+    {
+        m_background.copyTo(frame);
+    }
+
+    Point2f center = handPosition(m_frameIndex);
+    Size size = handSize(m_frameIndex);
+    if (m_scene.handTemplate.empty())
+    {
+        ellipse(frame, Point(cvRound(center.x), cvRound(center.y)), Size(size.width / 2, size.height / 2),
+                0.0, 0.0, 360.0, Scalar(120, 160, 220), FILLED, LINE_AA);
+    }
+    else
+    {
+        // The template is only resized when the hand size changes
+        if (m_scaledTemplate.size() != size)
+        {
+            resize(m_scene.handTemplate, m_scaledTemplate, size, 0.0, 0.0, INTER_AREA);
+            resize(m_scene.handMask, m_scaledMask, size, 0.0, 0.0, INTER_NEAREST);
+        }
+
+        // Pasted with its mask, clipped to the frame
+        Rect placed(cvRound(center.x - size.width / 2.0f), cvRound(center.y - size.height / 2.0f), size.width, size.height);
+        Rect visible = placed & Rect(Point(0, 0), m_size);
+        if (!visible.empty())
+        {
+            Rect source(visible.tl() - placed.tl(), visible.size());
+            m_scaledTemplate(source).copyTo(frame(visible), m_scaledMask(source));
+        }
+    }
+
+    // Global brightness change, then sensor noise
+    if (m_scene.lightingVariation > 0.0)
+    {
+        double t = m_frameIndex / m_frameRate;
+        double gain = 1.0 + m_scene.lightingVariation * std::sin(2.0 * CV_PI * t / m_scene.lightingPeriod);
+        frame.convertTo(frame, -1, std::max(0.0, gain));
+    }
+    if (!m_noise.empty())
+    {
+        add(frame, m_noise[m_frameIndex % m_noise.size()], frame, noArray(), CV_8U);
+    }
+
+    ++m_frameIndex;
+    return true;
+}
@@ -0,0 +1,130 @@
+#ifndef SYNTHETICFRAMESOURCE_H
+#define SYNTHETICFRAMESOURCE_H
+
+#include "frameSource.h"
+#include <vector>
+
+/**
+ * @brief Frames rendered from a scripted hand motion
+ *
+ * A hand follows a scripted path over a background, so the motion is perfectly
+ * reproducible and the true hand position and box of every frame are known.
+ *
+ * The default scene is a skin coloured blob on a plain background, used to measure
+ * the motion-to-photon latency on machines without a camera (the blob is found by
+ * the skin colour detector). A Scene can replace it with a hand template pasted over
+ * a textured background, with scale, lighting and noise changes, to load-test the
+ * pipeline at any resolution and frame rate and to check its tracking error.
+ */
+class SyntheticFrameSource : public FrameSource
+{
+public:
+    /**
+     * @brief Content and perturbations of the generated frames
+     */
+    struct Scene
+    {
+        Mat handTemplate;           // BGR hand image, empty for the plain skin coloured blob
+        Mat handMask;               // 8-bit mask of the template pixels, empty to use the non-black pixels
+        bool texturedBackground = false; // Generated texture (neutral chroma) instead of a plain dark background
+        Mat background;             // BGR background image resized to the frame, overrides the generated one
+        double handScale = 1.0;     // Hand height relative to a quarter of the frame height
+        double scaleVariation = 0.0; // Relative amplitude of the hand size oscillation (0.2 = +/-20 %)
+        double lightingVariation = 0.0; // Relative amplitude of the global brightness oscillation
+        double lightingPeriod = 4.0; // Period of the brightness oscillation (seconds)
+        double noiseSigma = 0.0;    // Standard deviation of the Gaussian sensor noise (grey levels)
+        std::vector<Point2f> path;  // Looped waypoints in normalized frame coordinates, empty for a Lissajous path
+        double pathPeriod = 2.0;    // Duration of one loop of the path (seconds)
+        unsigned int seed = 1;      // Seed of the background texture and the noise
+    };
+
+    /**
+     * @brief Constructor
+     * @param size Size of the generated frames
+     * @param frameRate Frame rate of the scripted time, and of RealTime pacing
+     * @param pacing Pacing of the delivered frames
+     */
+    explicit SyntheticFrameSource(const Size &size = Size(640, 480), double frameRate = 30.0,
+                                  Pacing pacing = RealTime);
+
+    bool isOpened() const override { return m_opened; }
+    void release() override { m_opened = false; }
+    QSize frameSize() const override { return QSize(m_size.width, m_size.height); }
+    double frameRate() const override { return m_frameRate; }
+    QString description() const override { return "synthetic motion"; }
+
+    /**
+     * @brief Replaces the rendered scene
+     * @param scene Template, background, path and perturbations
+     *
+     * The background and the noise are prepared here, rendering a frame then only
+     * copies, blends and adds buffers of the frame size.
+     */
+    void setScene(const Scene &scene);
+
+    /**
+     * @brief Get the rendered scene
+     * @return Current scene
+     */
+    const Scene &scene() const { return m_scene; }
+
+    /**
+     * @brief Creates a procedural hand template
+     * @param height Height of the template in pixels
+     * @param mask Receives the mask of the hand pixels
+     * @return BGR open hand with skin colour, shading and finger creases
+     */
+    static Mat createHandTemplate(int height, Mat &mask);
+
+    /**
+     * @brief Computes the scripted hand position of a frame
+     * @param frameIndex Index of the frame since the source was opened
+     * @return Center of the hand in frame coordinates (before mirroring)
+     */
+    Point2f handPosition(qint64 frameIndex) const;
+
+    /**
+     * @brief Computes the box of the hand in a frame
+     * @param frameIndex Index of the frame since the source was opened
+     * @return Hand bounding box in frame coordinates (before mirroring), clipped to the frame
+     */
+    Rect handRect(qint64 frameIndex) const;
+
+    /**
+     * @brief Get the index of the next frame
+     * @return Number of frames generated so far
+     */
+    qint64 frameIndex() const { return m_frameIndex; }
+
+protected:
+    bool readFrame(Mat &frame) override;
+
+private:
+    /**
+     * @brief Computes the scripted hand size of a frame
+     * @param frameIndex Index of the frame
+     * @return Width and height of the hand in pixels
+     */
+    Size handSize(qint64 frameIndex) const;
+
+    /**
+     * @brief Generates the textured background
+     * @return BGR texture of the frame size, free of skin chroma
+     */
+    Mat createBackground() const;
+
+    Size m_size;        // Size of the generated frames
+    double m_frameRate; // Frame rate of the scripted time
+    bool m_opened;      // Flag indicating if the source has not been released
+    qint64 m_frameIndex; // Index of the next frame
+
+    Scene m_scene;              // Rendered scene
+    Mat m_background;           // Background of the frame size, empty for the plain background
+    Mat m_scaledTemplate;       // Template resized to the last hand size (pooled)
+    Mat m_scaledMask;           // Mask resized to the last hand size (pooled)
+    std::vector<Mat> m_noise;   // Pregenerated signed noise frames, cycled through
+
+    static const int NOISE_FRAMES = 4; // Noise frames generated once, randn on every frame is too slow at 1080p
+};
+
+#endif // SYNTHETICFRAMESOURCE_H
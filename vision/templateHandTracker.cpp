@@ -0,0 +1,167 @@
+#include "templateHandTracker.h"
+#include <iostream>
+#include <QElapsedTimer>
+
+TemplateHandTracker::TemplateHandTracker()
+    : m_scale(1.0),
+      m_hasLastPosition(false)
+{
+}
+
+bool TemplateHandTracker::setReference(const Mat &reference)
+{
+    m_reference.release();
+    m_template.release();
+    m_scaledTemplates.clear();
+    m_scales.clear();
+    m_scale = 1.0;
+    m_hasLastPosition = false;
+
+    if (reference.empty())
+    {
+        return false;
+    }
+
+    // Correlation runs on grayscale, the float template accumulates the updates
+    if (reference.channels() == 3)
+    {
+        cvtColor(reference, m_reference, COLOR_BGR2GRAY);
+    }
+    else
+    {
+        m_reference = reference.clone();
+    }
+    m_reference.convertTo(m_template, CV_32F);
+    updateScaledTemplates();
+    return true;
+}
+
+void TemplateHandTracker::updateScaledTemplates()
+{
+    Mat current;
+    m_template.convertTo(current, CV_8U);
+
+    // One step smaller, the current size and one step larger, within the allowed range
+    m_scaledTemplates.resize(3);
+    m_scales.resize(3);
+    const double steps[3] = {1.0 / SCALE_STEP, 1.0, SCALE_STEP};
+    for (int i = 0; i < 3; i++)
+    {
+        m_scales[i] = std::max(MIN_SCALE, std::min(MAX_SCALE, m_scale * steps[i]));
+        Size size(std::max(8, cvRound(current.cols * m_scales[i])), std::max(8, cvRound(current.rows * m_scales[i])));
+        resize(current, m_scaledTemplates[i], size, 0.0, 0.0, m_scales[i] < 1.0 ? INTER_AREA : INTER_LINEAR);
+    }
+}
+
+TrackResult TemplateHandTracker::trackRoi(const Mat &frame, const Rect &roi)
+{
+    TrackResult result;
+
+    // Fall back to the center of the region of interest
+    result.position = Point2f(roi.x + roi.width / 2.0f, roi.y + roi.height / 2.0f);
+
+    if (frame.empty() || roi.empty() || m_template.empty())
+    {
+        return result;
+    }
+
+    try
+    {
+        // The region is widened by half the largest template, so the hand can be matched with
+        // its center anywhere in it, and covers the last match in case the region lags behind
+        const Mat &largest = m_scaledTemplates.back();
+        Rect window(roi.x - largest.cols / 2, roi.y - largest.rows / 2, roi.width + largest.cols, roi.height + largest.rows);
+        if (m_hasLastPosition)
+        {
+            window |= Rect(cvRound(m_lastPosition.x) - largest.cols, cvRound(m_lastPosition.y) - largest.rows,
+                           2 * largest.cols, 2 * largest.rows);
+        }
+        window &= Rect(0, 0, frame.cols, frame.rows);
+
+        QElapsedTimer stageTimer;
+        stageTimer.start();
+
+        // The pipeline passes its shared grayscale frame, the window is then only a view of it
+        Mat gray = frame(window);
+        if (frame.channels() == 3)
+        {
+            cvtColor(gray, m_gray, COLOR_BGR2GRAY);
+            gray = m_gray;
+        }
+        result.describeMs = stageTimer.nsecsElapsed() / 1.0e6;
+
+        // Best normalized correlation over the searched scales
+        stageTimer.restart();
+        double bestScore = -1.0;
+        Point bestLocation;
+        int bestIndex = -1;
+        for (size_t i = 0; i < m_scaledTemplates.size(); i++)
+        {
+            const Mat &scaled = m_scaledTemplates[i];
+            if (scaled.cols > gray.cols || scaled.rows > gray.rows)
+            {
+                continue;
+            }
+
+            double score = 0.0;
+            Point location;
+            matchTemplate(gray, scaled, m_scores, TM_CCOEFF_NORMED);
+            minMaxLoc(m_scores, nullptr, &score, nullptr, &location);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestLocation = location;
+                bestIndex = static_cast<int>(i);
+            }
+        }
+        result.matchMs = stageTimer.nsecsElapsed() / 1.0e6;
+
+        if (bestIndex < 0)
+        {
+            m_hasLastPosition = false;
+            return result;
+        }
+
+        // Quality grows from 0 at MIN_SCORE to 100 for a perfect correlation
+        const Mat &matched = m_scaledTemplates[bestIndex];
+        Rect box(window.tl() + bestLocation, matched.size());
+        result.matchQuality = std::max(0, std::min(100, cvRound((bestScore - MIN_SCORE) * 100.0 / (1.0 - MIN_SCORE))));
+        result.position = Point2f(box.x + box.width / 2.0f, box.y + box.height / 2.0f);
+        result.points.push_back(Point2f(box.tl()));
+        result.points.push_back(Point2f(box.x + box.width - 1.0f, box.y));
+        result.points.push_back(Point2f(box.br()) - Point2f(1.0f, 1.0f));
+        result.points.push_back(Point2f(box.x, box.y + box.height - 1.0f));
+        result.found = true;
+
+        if (bestScore < MIN_SCORE)
+        {
+            // Poor match: pull the template back towards the reference instead of learning from it
+            m_hasLastPosition = false;
+            accumulateWeighted(m_reference, m_template, REFERENCE_WEIGHT);
+            updateScaledTemplates();
+            return result;
+        }
+
+        m_lastPosition = result.position;
+        m_hasLastPosition = true;
+        m_scale = m_scales[bestIndex];
+
+        // Good match: blend the patch into the template so that it follows the hand
+        if (bestScore >= UPDATE_SCORE)
+        {
+            resize(gray(Rect(bestLocation, matched.size())), m_patch, m_template.size(), 0.0, 0.0, INTER_AREA);
+            accumulateWeighted(m_patch, m_template, UPDATE_RATE);
+        }
+        updateScaledTemplates();
+    }
+    catch (const cv::Exception &e)
+    {
+        std::cerr << "OpenCV error in TemplateHandTracker::trackRoi: " << e.what() << std::endl;
+        result.found = false;
+        result.matchQuality = 0;
+        result.points.clear();
+        m_hasLastPosition = false;
+    }
+
+    return result;
+}
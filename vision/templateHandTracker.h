@@ -0,0 +1,59 @@
+#ifndef TEMPLATEHANDTRACKER_H
+#define TEMPLATEHANDTRACKER_H
+
+#include "handTracker.h"
+
+/**
+ * @brief Hand tracker based on normalized cross-correlation with the reference patch
+ *
+ * The grayscale reference is searched with matchTemplate() inside the region of
+ * interest, widened around the last matched position, at a few scales around the
+ * current hand size. A good match is blended into the template so that it follows
+ * slow changes of pose and lighting, while the original reference bounds the drift.
+ *
+ * On a small region this costs a fraction of the keypoint backends; it is less
+ * tolerant of fast rotations and large pose changes.
+ */
+class TemplateHandTracker : public HandTracker
+{
+public:
+    /**
+     * @brief Constructor
+     */
+    TemplateHandTracker();
+
+    Backend backend() const override { return Template; }
+    bool setReference(const Mat &reference) override;
+
+protected:
+    using HandTracker::trackRoi;
+    TrackResult trackRoi(const Mat &frame, const Rect &roi) override;
+
+private:
+    /**
+     * @brief Resizes the template to the scales searched around the current one
+     */
+    void updateScaledTemplates();
+
+    Mat m_reference;        // Grayscale reference as captured
+    Mat m_template;         // Grayscale template, blended with good matches (CV_32F)
+    double m_scale;         // Scale of the hand relative to the reference
+    std::vector<Mat> m_scaledTemplates; // Template at each searched scale (CV_8U)
+    std::vector<double> m_scales;       // Scale of each entry of m_scaledTemplates
+    Point2f m_lastPosition; // Center of the last match in frame coordinates
+    bool m_hasLastPosition; // Flag indicating if the last frame was matched
+
+    Mat m_gray;             // Grayscale search window (pooled)
+    Mat m_scores;           // Correlation map of the last scale (pooled)
+    Mat m_patch;            // Matched patch resized to the template (pooled)
+
+    static constexpr double SCALE_STEP = 1.1;     // Ratio between two searched scales
+    static constexpr double MIN_SCALE = 0.5;      // Smallest hand size relative to the reference
+    static constexpr double MAX_SCALE = 2.0;      // Largest hand size relative to the reference
+    static constexpr double MIN_SCORE = 0.5;      // Correlation reported as a 0% match
+    static constexpr double UPDATE_SCORE = 0.8;   // Correlation above which the template is updated
+    static constexpr double UPDATE_RATE = 0.1;    // Weight of the matched patch in the template update
+    static constexpr double REFERENCE_WEIGHT = 0.5; // Weight of the reference restored when the score is poor
+};
+
+#endif // TEMPLATEHANDTRACKER_H
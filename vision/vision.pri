@@ -0,0 +1,54 @@
+# Hand detection and tracking pipeline, shared by the game and the slice-vision-bench tool
+# Requires QT += core gui concurrent in the including project
+
+SOURCES += \
+    $$PWD/detectionScheduler.cpp \
+    $$PWD/featureHandTracker.cpp \
+    $$PWD/frameOverlay.cpp \
+    $$PWD/framePacket.cpp \
+    $$PWD/frameSource.cpp \
+    $$PWD/handFilter.cpp \
+    $$PWD/handSampleHistory.cpp \
+    $$PWD/handTracker.cpp \
+    $$PWD/latencyHistogram.cpp \
+    $$PWD/latencyProbe.cpp \
+    $$PWD/opticalFlowTracker.cpp \
+    $$PWD/referenceBank.cpp \
+    $$PWD/sessionRecorder.cpp \
+    $$PWD/skinDetector.cpp \
+    $$PWD/syntheticFrameSource.cpp \
+    $$PWD/templateHandTracker.cpp \
+    $$PWD/visionPipeline.cpp \
+    $$PWD/visionProfiler.cpp \
+    $$PWD/visionWorker.cpp
+
+HEADERS += \
+    $$PWD/detectionScheduler.h \
+    $$PWD/featureHandTracker.h \
+    $$PWD/frameOverlay.h \
+    $$PWD/framePacket.h \
+    $$PWD/frameSource.h \
+    $$PWD/handFilter.h \
+    $$PWD/handSampleHistory.h \
+    $$PWD/handTrack.h \
+    $$PWD/handSample.h \
+    $$PWD/handTracker.h \
+    $$PWD/latencyHistogram.h \
+    $$PWD/latencyProbe.h \
+    $$PWD/latestValueMailbox.h \
+    $$PWD/opticalFlowTracker.h \
+    $$PWD/referenceBank.h \
+    $$PWD/sessionRecorder.h \
+    $$PWD/skinDetector.h \
+    $$PWD/syntheticFrameSource.h \
+    $$PWD/templateHandTracker.h \
+    $$PWD/visionClock.h \
+    $$PWD/visionPipeline.h \
+    $$PWD/visionProfiler.h \
+    $$PWD/visionSettings.h \
+    $$PWD/visionStats.h \
+    $$PWD/visionWorker.h
+
+INCLUDEPATH +=$$(OPENCV_DIR)\..\..\include
+
+LIBS += -L$$(OPENCV_DIR)\lib -lopencv_core4110 -lopencv_highgui4110 -lopencv_imgproc4110 -lopencv_imgcodecs4110 -lopencv_videoio4110 -lopencv_features2d4110 -lopencv_calib3d4110 -lopencv_objdetect4110 -lopencv_video4110
@@ -0,0 +1,21 @@
+#ifndef VISIONCLOCK_H
+#define VISIONCLOCK_H
+
+#include <QtGlobal>
+#include <chrono>
+
+/**
+ * @brief Monotonic clock shared by the vision thread and the game loop
+ * @return Current time in nanoseconds (arbitrary epoch, never goes backwards)
+ *
+ * All hand sample timestamps use this clock so that they can be compared with
+ * the time a frame is rendered.
+ */
+inline qint64 visionClockNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+#endif // VISIONCLOCK_H
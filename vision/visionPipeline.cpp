@@ -0,0 +1,906 @@
+#include "opencv2/opencv.hpp"
+#include "visionPipeline.h"
+#include <iostream>
+#include <QFile>
+#include <QTemporaryFile>
+#include <QtConcurrent/QtConcurrentRun>
+
+using namespace cv;
+using namespace std;
+
+VisionPipeline::VisionPipeline()
+    : references_(&keyframePool_)
+{
+    hasReference = false;
+    hasDetection = false;
+    consecutiveDetections = 0;
+    lowQualityCounter = 0;
+    noDetectionCounter = 0;
+    searchWindowLevel_ = 0;
+    matchQuality = 0;
+    confidence_ = 0.0;
+    frameIndex_ = 0;
+    detectionRan_ = false;
+    detectionTimer.start();
+    debug = false; // Set debug to false by default
+    logEnabled_ = true;
+
+    // Initialize hand position to middle of a 640x480 frame until a stream is attached
+    m_handPosition[0] = 320;
+    m_handPosition[1] = 240;
+
+    // The vision thread runs one cascade pass itself, the pool runs the two others
+    cascadePool_.setMaxThreadCount(2);
+
+    // A keyframe preparation never holds a thread a cascade pass is waiting for
+    keyframePool_.setMaxThreadCount(1);
+
+    // Parse the Haar cascades once, before the first frame is processed
+    cascadesLoaded_ = false;
+    loadCascades();
+
+    // Trackers are created once per keyframe and reused for every frame
+    references_.configure(settings_.trackerBackend, settings_.matchRatio, settings_.referenceKeyframes);
+}
+
+void VisionPipeline::applySettings(const VisionSettings &settings)
+{
+    // Keep tracking with the new backend without re-acquiring the hand: the keyframes are kept
+    references_.configure(settings.trackerBackend, settings.matchRatio, settings.referenceKeyframes);
+
+    // Stale flow state must not be resumed when flow is enabled again
+    if (!settings.opticalFlowEnabled)
+    {
+        flowTracker_.reset();
+        secondHand_.flow.reset();
+    }
+    if (settings.maxHands < 2)
+    {
+        secondHand_.reset();
+    }
+
+    scheduler_.applySettings(settings);
+    settings_ = settings;
+}
+
+void VisionPipeline::reset(FrameSource *source, int frameWidth, int frameHeight)
+{
+    // Reset detection states for the new stream
+    hasReference = false;
+    hasDetection = false;
+    consecutiveDetections = 0;
+    lowQualityCounter = 0;
+    noDetectionCounter = 0;
+    searchWindowLevel_ = 0;
+    scheduler_.reset(source ? source->frameRate() : 30.0);
+    flowTracker_.reset();
+    secondHand_.reset();
+    packet_.clearPyramids();
+    matchQuality = 0;
+    confidence_ = 0.0;
+    stats_ = VisionStats();
+    profiler_.clear();
+    detectionTimer.restart();
+
+    // Initialize hand position to middle of frame or reasonable fallback values
+    m_handPosition[0] = frameWidth > 0 ? frameWidth / 2 : 320;
+    m_handPosition[1] = frameHeight > 0 ? frameHeight / 2 : 240;
+}
+
+std::ostream &VisionPipeline::log()
+{
+    // A stream without buffer fails every write before formatting anything
+    static std::ostream discarded(nullptr);
+    return logEnabled_ ? std::cout : discarded;
+}
+
+bool VisionPipeline::loadCascadeFromResource(const QString &resource, CascadeClassifier &cascade)
+{
+    // OpenCV cannot read Qt resources directly, so the XML is copied to a
+    // temporary file that only lives for the duration of the load
+    QFile file(resource);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        cerr << "Error opening resource " << resource.toStdString() << endl;
+        return false;
+    }
+
+    QTemporaryFile tmp;
+    if (!tmp.open())
+    {
+        cerr << "Error creating temporary file for " << resource.toStdString() << endl;
+        return false;
+    }
+    tmp.write(file.readAll());
+    tmp.flush();
+
+    if (!cascade.load(tmp.fileName().toStdString()))
+    {
+        cerr << "Error loading cascade " << resource.toStdString() << endl;
+        return false;
+    }
+    return true;
+}
+
+bool VisionPipeline::loadCascades()
+{
+    if (cascadesLoaded_)
+    {
+        return true;
+    }
+
+    // A classifier must not run two detections at once, so the two palm passes get their own instance
+    cascadesLoaded_ = loadCascadeFromResource(":/hand.xml", fistCascade_) &&
+                      loadCascadeFromResource(":/Hand.Cascade.1.xml", palmCascade_) &&
+                      loadCascadeFromResource(":/Hand.Cascade.1.xml", palmGrayCascade_);
+    return cascadesLoaded_;
+}
+
+Rect VisionPipeline::searchWindow(const Size &frameSize) const
+{
+    Rect fullFrame(0, 0, frameSize.width, frameSize.height);
+
+    // No lock yet: scan the whole frame
+    if (!settings_.searchWindowEnabled || !hasDetection || lastDetectedRect.empty())
+    {
+        return fullFrame;
+    }
+
+    // A second hand can appear anywhere until it is tracked, then the window covers both hands
+    Rect window = expandedWindow(lastDetectedRect);
+    if (settings_.maxHands > 1)
+    {
+        if (!secondHand_.tracked || secondHand_.rect.empty())
+        {
+            return fullFrame;
+        }
+        window |= expandedWindow(secondHand_.rect);
+    }
+
+    return window & fullFrame;
+}
+
+Rect VisionPipeline::expandedWindow(const Rect &rect) const
+{
+    // Expanded window centered on the hand, growing with each consecutive miss
+    double scale = settings_.searchWindowScale * std::pow(settings_.searchWindowGrowth, searchWindowLevel_);
+    int width = std::max(MAX_DETECTION_SIZE, cvRound(rect.width * scale));
+    int height = std::max(MAX_DETECTION_SIZE, cvRound(rect.height * scale));
+    Point center(rect.x + rect.width / 2, rect.y + rect.height / 2);
+
+    return Rect(center.x - width / 2, center.y - height / 2, width, height);
+}
+
+int VisionPipeline::detectionScale(int frameWidth) const
+{
+    if (settings_.detectionScale > 0)
+    {
+        return settings_.detectionScale;
+    }
+
+    // Automatic: halve the resolution until the frame is no wider than 640 pixels
+    int scale = 1;
+    while (frameWidth / (scale * 2) >= AUTO_DETECTION_WIDTH)
+    {
+        scale *= 2;
+    }
+    return scale;
+}
+
+Rect VisionPipeline::detectHand(const Mat &image)
+{
+    // Only search around the last detection once the hand has been locked
+    Rect window = searchWindow(image.size());
+    bool isFullFrame = (window.size() == image.size());
+
+    // Every hand found is kept as a candidate, the first one goes to the first hand
+    Rect detectedRect;
+    candidates_.clear();
+    detectionRan_ = true;
+    stats_.detectionFrames++;
+    if (settings_.detectorBackend == VisionSettings::SkinColorDetector)
+    {
+        QElapsedTimer stageTimer;
+        stageTimer.start();
+        skinDetector_.detect(image, window, MIN_DETECTION_SIZE / 2, candidates_, settings_.maxHands);
+        profiler_.record(VisionProfiler::SkinDetection, stageTimer.nsecsElapsed() / 1.0e6);
+    }
+    else
+    {
+        haarCascade(image, window);
+    }
+
+    // With two hands in view, the first hand keeps the candidate closest to its last position
+    if (settings_.maxHands > 1 && candidates_.size() > 1 && hasDetection)
+    {
+        Point last(lastDetectedRect.x + lastDetectedRect.width / 2, lastDetectedRect.y + lastDetectedRect.height / 2);
+        auto distance = [&last](const Rect &rect)
+        {
+            Point center(rect.x + rect.width / 2, rect.y + rect.height / 2);
+            return (center - last).dot(center - last);
+        };
+        std::iter_swap(candidates_.begin(),
+                       std::min_element(candidates_.begin(), candidates_.end(), [&distance](const Rect &a, const Rect &b)
+                                        { return distance(a) < distance(b); }));
+    }
+    if (!candidates_.empty())
+    {
+        detectedRect = candidates_[0];
+    }
+    handRect_ = detectedRect;
+
+    // Update the window statistics and grow the window after a miss
+    if (isFullFrame)
+    {
+        stats_.fullFrameSearches++;
+        stats_.fullFrameHits += detectedRect.empty() ? 0 : 1;
+    }
+    else
+    {
+        stats_.windowSearches++;
+        stats_.windowHits += detectedRect.empty() ? 0 : 1;
+    }
+
+    if (!detectedRect.empty())
+    {
+        searchWindowLevel_ = 0;
+    }
+    else if (!isFullFrame)
+    {
+        searchWindowLevel_++;
+    }
+    stats_.searchWindowLevel = searchWindowLevel_;
+
+    // Draw detection rectangle only during initial detection phase
+    if (!hasReference && !detectedRect.empty())
+    {
+        overlay_.addRect(detectedRect, Scalar(0, 255, 0), 2);
+    }
+
+    return detectedRect;
+}
+
+Rect VisionPipeline::haarCascade(const Mat &image, const Rect &window)
+{
+    // Classifiers are parsed once and kept resident between frames
+    if (!loadCascades())
+    {
+        return Rect();
+    }
+
+    // Cascades run on a downsampled copy, sizes are expressed in full resolution pixels
+    int scale = detectionScale(image.cols);
+
+    // The grayscale frame is shared with the flow and the trackers, the equalized and
+    // inverted windows are computed once per frame by the packet
+    QElapsedTimer stageTimer;
+    stageTimer.start();
+    Mat frame_gray, invFrame_gray;
+    packet_.detectionImages(window, scale, frame_gray, invFrame_gray);
+    profiler_.record(VisionProfiler::Grayscale, stageTimer.nsecsElapsed() / 1.0e6);
+
+    fists_.clear();
+    invFists_.clear();
+    palms_.clear();
+
+    Size minSize(MIN_DETECTION_SIZE / scale, MIN_DETECTION_SIZE / scale);
+    Size maxSize(MAX_DETECTION_SIZE / scale, MAX_DETECTION_SIZE / scale);
+
+    // Each pass times itself, possibly on a pool thread; durations are recorded once all passes are done
+    double fistMs = -1.0, invertedPalmMs = -1.0, palmMs = -1.0;
+
+    // The passes are independent: fist on gray, palm on inverted gray, and palm on gray which
+    // is only used when the first two found nothing. The palm on inverted gray pass that used
+    // to follow it repeated the second pass on the same image and has been removed.
+    auto detectFists = [&]()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        fistCascade_.detectMultiScale(frame_gray, fists_, 1.1, 13, 1, minSize, maxSize);
+        fistMs = timer.nsecsElapsed() / 1.0e6;
+    };
+    auto detectInvertedPalms = [&]()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        palmCascade_.detectMultiScale(invFrame_gray, invFists_, 1.1, 13, 1, minSize, maxSize);
+        invertedPalmMs = timer.nsecsElapsed() / 1.0e6;
+    };
+    auto detectPalms = [&]()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        palmGrayCascade_.detectMultiScale(frame_gray, palms_, 1.1, 13, 1, minSize, maxSize);
+        palmMs = timer.nsecsElapsed() / 1.0e6;
+    };
+
+    if (settings_.parallelCascades)
+    {
+        // Dispatch the other passes on the pool and run the fist pass on this thread meanwhile.
+        // With early cancel the palm pass is not started speculatively, it only runs if needed below.
+        QFuture<void> invertedPalmsDone = QtConcurrent::run(&cascadePool_, detectInvertedPalms);
+        QFuture<void> palmsDone;
+        if (!settings_.palmEarlyCancel)
+        {
+            palmsDone = QtConcurrent::run(&cascadePool_, detectPalms);
+        }
+
+        detectFists();
+        invertedPalmsDone.waitForFinished();
+        fists_.insert(fists_.end(), invFists_.begin(), invFists_.end());
+
+        if (!settings_.palmEarlyCancel)
+        {
+            palmsDone.waitForFinished();
+        }
+        else if (fists_.empty())
+        {
+            detectPalms();
+        }
+    }
+    else
+    {
+        // First try to detect fists
+        detectFists();
+        detectInvertedPalms();
+        fists_.insert(fists_.end(), invFists_.begin(), invFists_.end());
+
+        // Second attempt: detect palms if no fists found
+        if (fists_.empty())
+        {
+            detectPalms();
+        }
+    }
+
+    if (fistMs >= 0.0)
+    {
+        profiler_.record(VisionProfiler::CascadeFist, fistMs);
+    }
+    if (invertedPalmMs >= 0.0)
+    {
+        profiler_.record(VisionProfiler::CascadeInvertedPalm, invertedPalmMs);
+    }
+    if (palmMs >= 0.0)
+    {
+        profiler_.record(VisionProfiler::CascadePalm, palmMs);
+    }
+
+    // Prioritize fist detection over palm detection
+    const std::vector<Rect> &found = fists_.empty() ? palms_ : fists_;
+
+    // Detections are relative to the downsampled search window, map them back to the frame
+    for (size_t i = 0; i < found.size(); i++)
+    {
+        candidates_.push_back(Rect(found[i].x * scale, found[i].y * scale,
+                                   found[i].width * scale, found[i].height * scale) +
+                              window.tl());
+    }
+
+    return candidates_.empty() ? Rect() : candidates_[0];
+}
+
+Rect VisionPipeline::referenceRect(const Rect &detection, const Size &frameSize) const
+{
+    // Get frame dimensions for boundary checking
+    int frameWidth = frameSize.width;
+    int frameHeight = frameSize.height;
+
+    // Safety check - ensure the detection rectangle is within the frame boundaries
+    Rect safeRect = detection;
+    safeRect.x = std::max(0, std::min(frameWidth - 1, safeRect.x));
+    safeRect.y = std::max(0, std::min(frameHeight - 1, safeRect.y));
+    safeRect.width = std::min(frameWidth - safeRect.x, safeRect.width);
+    safeRect.height = std::min(frameHeight - safeRect.y, safeRect.height);
+
+    // Skip if rectangle is too small after safety adjustments
+    if (safeRect.width < 10 || safeRect.height < 10)
+    {
+        log() << "Warning: Adjusted rectangle too small for reference image" << std::endl;
+        return Rect();
+    }
+
+    // Adjust detection rectangle to better focus on the hand
+    Rect adjustedRect = safeRect;
+    adjustedRect.y = std::min(frameHeight - 1, adjustedRect.y + static_cast<int>(adjustedRect.height * 0.2));
+
+    // Ensure adjusted height doesn't go beyond frame boundary
+    adjustedRect.height = std::min(frameHeight - adjustedRect.y, adjustedRect.height);
+
+    // Calculate crop dimensions to focus on central part of hand
+    int cropX = static_cast<int>(adjustedRect.width * 0.3);
+    int cropY = static_cast<int>(-adjustedRect.height * 0.2);
+
+    // Ensure cropY doesn't move the rectangle outside the frame
+    cropY = std::max(-adjustedRect.y, cropY);
+
+    // Define final rectangle for reference image with boundary checks
+    Rect finalRect(
+        std::max(0, adjustedRect.x + cropX),
+        std::max(0, adjustedRect.y + cropY),
+        std::min(frameWidth - (adjustedRect.x + cropX), adjustedRect.width - 2 * cropX),
+        std::min(frameHeight - (adjustedRect.y + cropY), adjustedRect.height - 2 * cropY));
+
+    // Ensure the final rectangle is not empty or too small
+    if (finalRect.width <= 0 || finalRect.height <= 0 ||
+        finalRect.width < 10 || finalRect.height < 10)
+    {
+        log() << "Warning: Invalid reference rectangle dimensions" << std::endl;
+        return Rect();
+    }
+
+    return finalRect;
+}
+
+void VisionPipeline::captureReference()
+{
+    // The reference is cut from the frame the hand was detected on, the source is not read again
+    const Mat &frame = packet_.bgr();
+    if (frame.empty() || !hasDetection)
+    {
+        return;
+    }
+
+    Rect finalRect = referenceRect(lastDetectedRect, frame.size());
+    if (finalRect.empty())
+    {
+        return;
+    }
+
+    try
+    {
+        // Extract region of interest and store as reference
+        Mat roi = frame(finalRect);
+        reference = roi.clone();
+        hasReference = true;
+
+        // Compute the reference features once for all following frames, the bank restarts from it
+        references_.setReference(reference);
+
+        // Display reference image when in debug mode
+        if (debug)
+        {
+            namedWindow("Reference Image", WINDOW_NORMAL);
+            imshow("Reference Image", reference);
+            resizeWindow("Reference Image", reference.cols, reference.rows);
+            waitKey(1); // Refresh the window
+        }
+    }
+    catch (const cv::Exception &e)
+    {
+        std::cerr << "OpenCV error in captureReference: " << e.what() << std::endl;
+        hasReference = false;
+    }
+}
+
+QString VisionPipeline::statusText() const
+{
+    if (!hasDetection)
+    {
+        return "...";
+    }
+    else if (!hasReference)
+    {
+        return QString("%1/%2").arg(consecutiveDetections).arg(settings_.requiredDetections);
+    }
+    else
+    {
+        QString status = QString("%1% %2 (%3 ms)")
+                             .arg(matchQuality)
+                             .arg(HandTracker::backendNames().value(references_.backend()).toLower())
+                             .arg(references_.lastCostMs(), 0, 'f', 1);
+        if (references_.capacity() > 1)
+        {
+            status += QString(" key %1/%2").arg(references_.activeKeyframe() + 1).arg(references_.size());
+        }
+        return status;
+    }
+}
+
+bool VisionPipeline::isDetectionClose(const Rect &current, const Rect &previous)
+{
+    // Calculate the centers of both rectangles
+    Point currentCenter(current.x + current.width / 2, current.y + current.height / 2);
+    Point previousCenter(previous.x + previous.width / 2, previous.y + previous.height / 2);
+
+    // Calculate the Euclidean distance between centers
+    double distance = sqrt(pow(currentCenter.x - previousCenter.x, 2) +
+                           pow(currentCenter.y - previousCenter.y, 2));
+
+    // Calculate the average size of the rectangles
+    double avgSize = (current.width + current.height + previous.width + previous.height) / 4.0;
+
+    // Consider it close if the distance is less than 30% of the average size
+    return distance < (0.3 * avgSize);
+}
+
+void VisionPipeline::processFrame(const Mat &frame)
+{
+    // The frame is read once per tick and mirrored into the packet shared by all the stages
+    QElapsedTimer stageTimer;
+    stageTimer.start();
+    frameIndex_++;
+    packet_.reset(frame, frameIndex_);
+    profiler_.record(VisionProfiler::Flip, stageTimer.nsecsElapsed() / 1.0e6);
+    overlay_.clear();
+    detectionRan_ = false;
+    handRect_ = Rect();
+
+    // Only a position tracked on this frame is trusted
+    confidence_ = 0.0;
+
+    // The second hand reuses the detections and the flow pyramid of the first one
+    trackFirstHand();
+    trackSecondHand();
+}
+
+void VisionPipeline::trackFirstHand()
+{
+    QElapsedTimer stageTimer;
+
+    // Phase 1: Hand detection and reference image capture
+    if (!hasReference)
+    {
+        Rect detected = detectHand(packet_.bgr());
+        if (detected.width > 0 && detected.height > 0)
+        {
+            bool isClose = false;
+            if (hasDetection)
+            {
+                isClose = isDetectionClose(detected, lastDetectedRect);
+            }
+
+            // Check if the new detection is close to the previous one or if this is the first detection
+            if (isClose || !hasDetection)
+            {
+                // Check if we haven't timed out (5 seconds since last detection)
+                if (detectionTimer.elapsed() < 5000 || !hasDetection)
+                {
+                    consecutiveDetections++;
+                }
+                else
+                {
+                    // It's been too long since the last detection, reset counter
+                    consecutiveDetections = 1;
+                }
+            }
+            else
+            {
+                // Detection is not close to the previous one, reset counter
+                consecutiveDetections = 1;
+            }
+
+            lastDetectedRect = detected;
+            hasDetection = true;
+            detectionTimer.restart();
+
+            // Log detection progress
+            log() << consecutiveDetections << "/" << settings_.requiredDetections << std::endl;
+
+            // Capture reference once we have enough consistent detections
+            if (consecutiveDetections >= settings_.requiredDetections)
+            {
+                captureReference();
+                log() << "Reference captured!" << std::endl;
+            }
+        }
+        else
+        {
+            // Reset if no detection for too long
+            if (detectionTimer.elapsed() > 5000 && consecutiveDetections > 0)
+            {
+                log() << "No detection for too long, resetting counter" << std::endl;
+                consecutiveDetections = 0;
+                hasDetection = false;
+            }
+        }
+    }
+    // Phase 2: Feature matching and tracking
+    else
+    {
+        // Cheap frames: follow the hand with optical flow until confidence drops or a re-detect is due
+        if (settings_.opticalFlowEnabled)
+        {
+            stageTimer.start();
+            bool tracked = trackWithOpticalFlow();
+            double flowMs = stageTimer.nsecsElapsed() / 1.0e6;
+            profiler_.record(VisionProfiler::OpticalFlow, flowMs);
+            if (tracked)
+            {
+                scheduler_.recordTrackedFrame(flowMs);
+                stats_.trackedFrames++;
+                stats_.redetectInterval = scheduler_.interval();
+                return;
+            }
+        }
+
+        // Annotations go to the overlay, the frame itself stays clean for the cascades and the tracker
+        stageTimer.start();
+        Rect detected = detectHand(packet_.bgr());
+
+        if (detected.width > 0 && detected.height > 0)
+        {
+            lastDetectedRect = detected;
+
+            // Ensure the detected rectangle is within frame boundaries
+            int frameWidth = packet_.bgr().cols;
+            int frameHeight = packet_.bgr().rows;
+
+            Rect safeRect = lastDetectedRect;
+            safeRect.x = std::max(0, std::min(frameWidth - 1, safeRect.x));
+            safeRect.y = std::max(0, std::min(frameHeight - 1, safeRect.y));
+            safeRect.width = std::min(frameWidth - safeRect.x, safeRect.width);
+            safeRect.height = std::min(frameHeight - safeRect.y, safeRect.height);
+
+            // Skip processing if the rectangle is too small after adjustments
+            if (safeRect.width < 10 || safeRect.height < 10)
+            {
+                log() << "Warning: Adjusted rectangle too small for feature matching" << std::endl;
+                return;
+            }
+
+            // Track the hand inside the safe rectangle with the best keyframe of the selected backend,
+            // on the grayscale frame already converted for the cascades
+            TrackResult result = references_.track(packet_.gray(), safeRect);
+            matchQuality = result.matchQuality;
+            profiler_.record(VisionProfiler::FeatureDetect, result.describeMs);
+            if (result.matchMs > 0.0)
+            {
+                profiler_.record(VisionProfiler::FeatureMatch, result.matchMs);
+            }
+
+            // Draw detection rectangle
+            overlay_.addRect(safeRect, Scalar(0, 255, 0), 1);
+
+            // Fallback to center point if matching quality is poor
+            if (matchQuality < 5)
+            {
+                lowQualityCounter++;
+
+                // Draw the middle point of the detection as fallback
+                Point centerPoint(safeRect.x + safeRect.width / 2,
+                                  safeRect.y + safeRect.height / 2);
+
+                // Update the tracked hand position
+                setTrackedHandPosition(centerPoint.x, centerPoint.y);
+                confidence_ = FALLBACK_CONFIDENCE;
+
+                // Draw a red circle at the tracking point for visibility
+                overlay_.addPoint(centerPoint, 5, Scalar(0, 0, 255));
+
+                log() << "Low match quality, using detection center. Counter: "
+                          << lowQualityCounter << "/10" << std::endl;
+
+                // A pose or lighting none of the keyframes covers: the detection becomes a new keyframe
+                if (lowQualityCounter == KEYFRAME_POOR_MATCHES)
+                {
+                    Rect keyframeRect = referenceRect(safeRect, packet_.bgr().size());
+                    if (!keyframeRect.empty() && references_.addKeyframe(packet_.bgr()(keyframeRect)))
+                    {
+                        log() << "Adding reference keyframe..." << std::endl;
+                    }
+                }
+
+                // Consistently poor matches: the keyframes keep tracking and the next poor matches add
+                // another keyframe, a single reference is captured again
+                if (lowQualityCounter > 10 && references_.capacity() > 1)
+                {
+                    log() << "Consistently poor matches, keeping the reference keyframes" << std::endl;
+                    lowQualityCounter = 0;
+                }
+                else if (lowQualityCounter > 10)
+                {
+                    log() << "Consistently poor matches, capturing new reference..." << std::endl;
+                    hasReference = false;
+                    flowTracker_.reset();
+                    consecutiveDetections = 0;
+                    lowQualityCounter = 0;
+                }
+            }
+            else
+            {
+                // Good match - reset counter and draw keypoints
+                lowQualityCounter = 0;
+
+                // Average position of the keypoints (or detection center if there are none)
+                Point trackedPoint(cvRound(result.position.x), cvRound(result.position.y));
+                setTrackedHandPosition(trackedPoint.x, trackedPoint.y);
+                confidence_ = std::min(1.0, matchQuality / double(FULL_CONFIDENCE_QUALITY));
+
+                // Draw a red circle at the tracking point
+                overlay_.addPoint(trackedPoint, 5, Scalar(0, 0, 255));
+
+                // Visualize keypoints
+                for (const Point2f &pt : result.points)
+                {
+                    // Check if the point is within the frame boundaries
+                    if (pt.x >= 0 && pt.x < frameWidth && pt.y >= 0 && pt.y < frameHeight)
+                    {
+                        overlay_.addPoint(pt, 2, Scalar(0, 255, 0));
+                    }
+                }
+            }
+
+            // Follow the hand with optical flow from this detection, until the scheduler asks for the next one
+            if (settings_.opticalFlowEnabled && hasReference)
+            {
+                flowTracker_.seed(packet_.pyramid(), packet_.gray(), safeRect, Point2f(m_handPosition[0], m_handPosition[1]));
+            }
+            scheduler_.recordDetection(matchQuality, stageTimer.nsecsElapsed() / 1.0e6);
+            stats_.redetectInterval = scheduler_.interval();
+
+            log() << "Match: " << matchQuality << "%" << std::endl;
+        }
+        else
+        {
+            flowTracker_.reset();
+
+            // Reset match quality when no detection
+            if (matchQuality > 0)
+            {
+                log() << "Match: 0%" << std::endl;
+                matchQuality = 0;
+            }
+
+            // Reset reference if consistently can't detect anything
+            noDetectionCounter++;
+
+            if (noDetectionCounter > 60)
+            {
+                // With keyframes, the hand is matched again as soon as it is detected, without re-acquisition
+                if (references_.capacity() > 1)
+                {
+                    log() << "No detection for too long, keeping the reference keyframes" << std::endl;
+                }
+                else
+                {
+                    log() << "No detection for too long, resetting reference..." << std::endl;
+                    hasReference = false;
+                    consecutiveDetections = 0;
+                }
+                flowTracker_.reset();
+                noDetectionCounter = 0;
+            }
+        }
+    }
+}
+
+bool VisionPipeline::trackWithOpticalFlow()
+{
+    // A full detection is due
+    if (!flowTracker_.isActive() || scheduler_.detectionDue())
+    {
+        return false;
+    }
+
+    // Flow lost or not trustworthy enough: fall back to the cascades and detect more often
+    const FlowPyramid &pyramid = packet_.pyramid();
+    if (!flowTracker_.update(packet_.previousPyramid(), pyramid) || flowTracker_.confidence() < settings_.flowMinConfidence)
+    {
+        flowTracker_.reset();
+        scheduler_.recordTrackingLost();
+        return false;
+    }
+
+    // Move the hand and the detection region along with the flow
+    lastDetectedRect = flowTracker_.trackedRect();
+    handRect_ = lastDetectedRect;
+    Point trackedPoint(cvRound(flowTracker_.position().x), cvRound(flowTracker_.position().y));
+    setTrackedHandPosition(trackedPoint.x, trackedPoint.y);
+    confidence_ = flowTracker_.confidence();
+
+    // Draw the flow region and points in orange to tell them apart from detections
+    overlay_.addRect(lastDetectedRect, Scalar(0, 128, 255), 1);
+    for (const Point2f &pt : flowTracker_.points())
+    {
+        overlay_.addPoint(pt, 2, Scalar(0, 128, 255));
+    }
+    overlay_.addPoint(trackedPoint, 5, Scalar(0, 0, 255));
+
+    return true;
+}
+
+void VisionPipeline::trackSecondHand()
+{
+    secondHand_.confidence = 0.0;
+    if (settings_.maxHands < 2)
+    {
+        return;
+    }
+
+    // Between two detections: follow the hand with optical flow, if it was seeded
+    if (!detectionRan_)
+    {
+        if (!secondHand_.flow.isActive())
+        {
+            return;
+        }
+
+        const FlowPyramid &pyramid = packet_.pyramid();
+        if (!secondHand_.flow.update(packet_.previousPyramid(), pyramid) ||
+            secondHand_.flow.confidence() < settings_.flowMinConfidence)
+        {
+            secondHand_.flow.reset();
+            return;
+        }
+
+        secondHand_.rect = secondHand_.flow.trackedRect();
+        secondHand_.position = Point(cvRound(secondHand_.flow.position().x), cvRound(secondHand_.flow.position().y));
+        secondHand_.confidence = secondHand_.flow.confidence();
+        overlay_.addRect(secondHand_.rect, Scalar(255, 128, 255), 1);
+        overlay_.addPoint(secondHand_.position, 5, Scalar(255, 0, 255));
+        return;
+    }
+
+    // Detection frame: the second hand is a candidate that is not the first hand, the closest
+    // to its last region once tracked, otherwise the largest one
+    Rect frameRect(0, 0, packet_.bgr().cols, packet_.bgr().rows);
+    Rect found;
+    double bestScore = 0.0;
+    for (size_t i = 1; i < candidates_.size(); i++)
+    {
+        const Rect &candidate = candidates_[i];
+        if ((candidate & candidates_[0]).area() > 0 || isDetectionClose(candidate, candidates_[0]))
+        {
+            continue;
+        }
+
+        double score = candidate.area();
+        if (secondHand_.tracked && !secondHand_.rect.empty())
+        {
+            Point offset = (candidate.tl() + candidate.br()) / 2 - (secondHand_.rect.tl() + secondHand_.rect.br()) / 2;
+            score = 1.0 / (1.0 + offset.dot(offset));
+        }
+        if (found.empty() || score > bestScore)
+        {
+            found = candidate;
+            bestScore = score;
+        }
+    }
+    found &= frameRect;
+
+    secondHand_.flow.reset();
+    if (found.width < 10 || found.height < 10)
+    {
+        // Keep the last region in the search window for a few detections before dropping the hand
+        if (++secondHand_.missedDetections > SECOND_HAND_MAX_MISSES)
+        {
+            secondHand_.reset();
+        }
+        return;
+    }
+
+    secondHand_.rect = found;
+    secondHand_.position = Point(found.x + found.width / 2, found.y + found.height / 2);
+    secondHand_.confidence = DETECTION_CONFIDENCE;
+    secondHand_.missedDetections = 0;
+    secondHand_.tracked = true;
+    overlay_.addRect(found, Scalar(255, 0, 255), hasReference ? 1 : 2);
+    overlay_.addPoint(secondHand_.position, 5, Scalar(255, 0, 255));
+
+    // Like the first hand, flow only bridges detections once they are no longer run every frame
+    if (settings_.opticalFlowEnabled && hasReference)
+    {
+        secondHand_.flow.seed(packet_.pyramid(), packet_.gray(), found, Point2f(secondHand_.position));
+    }
+}
+
+Mat VisionPipeline::rotateImage(const Mat &src, float angle)
+{
+    // Calculate image center
+    Point2f center(src.cols / 2.0f, src.rows / 2.0f);
+
+    // Create rotation matrix
+    Mat rotMatrix = getRotationMatrix2D(center, angle, 1.0);
+
+    // Apply rotation
+    Mat result;
+    warpAffine(src, result, rotMatrix, src.size());
+
+    return result;
+}
+
+void VisionPipeline::setTrackedHandPosition(int x, int y)
+{
+    m_handPosition[0] = x;
+    m_handPosition[1] = y;
+}
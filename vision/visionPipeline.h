@@ -0,0 +1,320 @@
+#ifndef VISIONPIPELINE_H
+#define VISIONPIPELINE_H
+
+#include "opencv2/opencv.hpp"
+#include <QString>
+#include <QPoint>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <ostream>
+#include "frameSource.h"
+#include "detectionScheduler.h"
+#include "frameOverlay.h"
+#include "framePacket.h"
+#include "handTrack.h"
+#include "handTracker.h"
+#include "opticalFlowTracker.h"
+#include "referenceBank.h"
+#include "skinDetector.h"
+#include "visionSettings.h"
+#include "visionProfiler.h"
+#include "visionStats.h"
+
+using namespace cv;
+
+/**
+ * @brief The VisionPipeline class holds the hand detection and tracking logic
+ *
+ * The pipeline has no dependency on widgets so it can run on the vision worker thread:
+ * - Detects hand positions using Haar cascades or skin colour segmentation
+ * - Establishes a reference image after consistent detection, then keeps keyframes
+ *   of the hand in other poses and lighting in a bank
+ * - Tracks hand position using feature matching (SIFT, ORB, BRISK or AKAZE) or template matching
+ * - Follows the hand with sparse optical flow between two cascade detections, the
+ *   detections being scheduled from the tracking quality and the frame budget
+ * - Optionally follows a second hand found by the same detections (two-sword mode)
+ *
+ * All methods must be called from the thread that processes the frames.
+ * Frame sized buffers are pooled in the pipeline and reused, so processing a frame
+ * does not allocate image memory once the frame size is stable.
+ */
+class VisionPipeline
+{
+public:
+    /**
+     * @brief Constructor loads the cascade classifiers
+     */
+    VisionPipeline();
+
+    /**
+     * @brief Applies a new runtime configuration
+     * @param settings Settings to apply
+     *
+     * Switching the tracker backend or its ratio threshold keeps the current reference keyframes.
+     */
+    void applySettings(const VisionSettings &settings);
+
+    /**
+     * @brief Resets detection and tracking state for a new video stream
+     * @param source Source the frames come from (used for its frame rate), not owned
+     * @param frameWidth Width of the frames in pixels
+     * @param frameHeight Height of the frames in pixels
+     */
+    void reset(FrameSource *source, int frameWidth, int frameHeight);
+
+    /**
+     * @brief Runs detection and tracking on one camera frame
+     * @param frame Raw frame read from the source, left untouched
+     *
+     * The mirrored frame and its annotations are available through frame() and overlay() afterwards.
+     */
+    void processFrame(const Mat &frame);
+
+    /**
+     * @brief Get the last processed frame
+     * @return Mirrored BGR frame, without annotations (pooled, overwritten by the next frame)
+     */
+    const Mat &frame() const { return packet_.bgr(); }
+
+    /**
+     * @brief Get the annotations of the last processed frame
+     * @return Detection and tracking shapes in frame coordinates
+     */
+    const FrameOverlay &overlay() const { return overlay_; }
+
+    /**
+     * @brief Get the current tracked hand position in frame coordinates
+     * @return QPoint containing the x,y coordinates of the tracked hand
+     */
+    QPoint trackedHandPosition() const { return QPoint(m_handPosition[0], m_handPosition[1]); }
+
+    /**
+     * @brief Get the quality of the last feature match
+     * @return Match quality between 0 and 100
+     */
+    int getMatchQuality() const { return matchQuality; }
+
+    /**
+     * @brief Get the confidence of the hand position tracked on the last frame
+     * @return 0 if the position was not updated, up to 1 for a good match or a stable flow
+     */
+    double trackingConfidence() const { return confidence_; }
+
+    /**
+     * @brief Get the region of the first hand found on the last frame
+     * @return Detected or flow tracked region in frame coordinates, empty if the hand was not found
+     */
+    const Rect &handRect() const { return handRect_; }
+
+    /**
+     * @brief Check if the reference image has been captured
+     * @return true once the pipeline tracks the hand against its reference
+     */
+    bool isTracking() const { return hasReference; }
+
+    /**
+     * @brief Get the tracking state of the second hand
+     * @return Second hand, only tracked when VisionSettings::maxHands is 2
+     */
+    const HandTrack &secondHand() const { return secondHand_; }
+
+    /**
+     * @brief Get the pipeline counters
+     * @return Statistics accumulated since the last reset
+     */
+    const VisionStats &stats() const { return stats_; }
+
+    /**
+     * @brief Get the stage latency histograms
+     * @return Profiler of the pipeline, the worker records the capture and preview stages in it
+     */
+    VisionProfiler &profiler() { return profiler_; }
+
+    /**
+     * @brief Get the status text describing the current detection state
+     * @return "..." while searching, detection progress, or match quality and cost of the tracker
+     */
+    QString statusText() const;
+
+    /**
+     * @brief Enables or disables the per-frame log on the standard output
+     * @param enabled false to keep the standard output for a report (errors are still printed)
+     */
+    void setLogEnabled(bool enabled) { logEnabled_ = enabled; }
+
+    /**
+     * @brief Loads the fist and palm classifiers once and caches them
+     * @return true if both classifiers are available
+     */
+    bool loadCascades();
+
+private:
+    FramePacket packet_;    // Last processed frame and the images derived from it, shared by all the stages
+    FrameOverlay overlay_;  // Annotations of the last processed frame
+
+    Mat reference;     // Reference image for feature matching
+    bool hasReference; // Flag indicating if a reference image has been captured
+
+    VisionSettings settings_; // Current runtime configuration
+    QThreadPool keyframePool_; // Thread preparing the reference keyframes, apart from the cascade passes
+    ReferenceBank references_; // Reference keyframes with a tracker of the selected backend each
+
+    QElapsedTimer detectionTimer; // Timer for detection duration
+
+    Rect lastDetectedRect;     // Last detected rectangle for hand position
+    Rect handRect_;            // Region of the first hand found on the current frame (empty if not found)
+    bool hasDetection;         // Flag indicating if a hand has been detected
+    int consecutiveDetections; // Count of consecutive detections
+    int lowQualityCounter;     // Count of consecutive poor feature matches
+    int noDetectionCounter;    // Count of consecutive frames without detection while tracking
+
+    int searchWindowLevel_;    // Growth step of the Haar search window (0 = smallest window)
+    DetectionScheduler scheduler_; // Decides which tracked frames run the full detection
+
+    OpticalFlowTracker flowTracker_; // Optical flow tracker seeded by detections
+    quint64 frameIndex_;             // Index of the processed frame, increases with each frame
+
+    HandTrack secondHand_;           // Second hand of the two-sword mode
+    std::vector<Rect> candidates_;   // Hands found by the detection of the current frame, first hand first
+    bool detectionRan_;              // Flag indicating if the detector ran on the current frame
+
+    std::vector<Rect> fists_, invFists_, palms_; // Cascade results, reused between frames
+    VisionStats stats_;        // Pipeline counters
+    VisionProfiler profiler_;  // Stage latency histograms
+
+    static const int MIN_DETECTION_SIZE = 80;  // Minimum hand size searched by the cascades (pixels)
+    static const int MAX_DETECTION_SIZE = 160; // Maximum hand size searched by the cascades (pixels)
+    static const int AUTO_DETECTION_WIDTH = 640; // Width the automatic detection scale downsamples to
+    int matchQuality; // Quality of the feature match (0-100)
+    double confidence_; // Confidence of the position tracked on the last frame (0-1)
+    static const int FULL_CONFIDENCE_QUALITY = 20; // Match quality considered fully reliable
+    static constexpr double FALLBACK_CONFIDENCE = 0.25; // Confidence of the detection center fallback
+    static constexpr double DETECTION_CONFIDENCE = 0.5; // Confidence of a second hand position taken from a detection
+    static const int SECOND_HAND_MAX_MISSES = 5; // Detections without the second hand before it is dropped
+    static const int KEYFRAME_POOR_MATCHES = 3; // Consecutive poor matches before the detection is added as a keyframe
+
+    CascadeClassifier fistCascade_; // Cached fist classifier (hand.xml)
+    CascadeClassifier palmCascade_; // Cached palm classifier (Hand.Cascade.1.xml), used on the inverted image
+    CascadeClassifier palmGrayCascade_; // Second palm classifier instance, used on the gray image
+    QThreadPool cascadePool_;       // Threads running cascade passes concurrently with the vision thread
+    SkinDetector skinDetector_;     // Skin colour detector, alternative to the cascades
+    bool cascadesLoaded_;           // Flag indicating if both classifiers are loaded
+
+    bool debug; // Flag for enabling/disabling debug mode
+    bool logEnabled_; // Flag enabling the per-frame log on the standard output
+
+    /**
+     * @brief Get the stream of the per-frame log
+     * @return std::cout, or a stream discarding the output when the log is disabled
+     */
+    std::ostream &log();
+
+    /**
+     * @brief Stores the tracked hand position in frame coordinates
+     * [0] = x-coordinate, [1] = y-coordinate
+     */
+    int m_handPosition[2];
+
+    /**
+     * @brief Set the tracked hand position
+     * @param x X-coordinate of the hand position
+     * @param y Y-coordinate of the hand position
+     *
+     * Updates the internal tracking of hand position that controls the player's sword.
+     */
+    void setTrackedHandPosition(int x, int y);
+
+    bool isDetectionClose(const Rect &current, const Rect &previous);
+
+    /**
+     * @brief Loads a cascade classifier stored in the Qt resources
+     * @param resource Resource path of the cascade XML file
+     * @param cascade Classifier to load
+     * @return true if the classifier was loaded, false otherwise
+     */
+    static bool loadCascadeFromResource(const QString &resource, CascadeClassifier &cascade);
+
+    /**
+     * @brief Computes the region searched by the cascades for the current frame
+     * @param frameSize Size of the frame
+     * @return Window around the last detection (and the second hand), or the whole frame when there is no lock
+     */
+    Rect searchWindow(const Size &frameSize) const;
+
+    /**
+     * @brief Computes the search window around a tracked hand
+     * @param rect Last region of the hand
+     * @return Region expanded with the current growth level (not clipped to the frame)
+     */
+    Rect expandedWindow(const Rect &rect) const;
+
+    /**
+     * @brief Get the downsampling factor used for cascade detection
+     * @param frameWidth Width of the full resolution frame
+     * @return Configured scale, or the automatic one (1 at 640 pixels wide, 2 at 1280...)
+     */
+    int detectionScale(int frameWidth) const;
+
+    /**
+     * @brief Detects the hand with the selected detector backend
+     * @param image Input image to process, the detection is recorded in the overlay
+     * @return Rectangle containing detected hand (empty if no detection)
+     *
+     * Searches the window around the last detection and updates the search window statistics.
+     */
+    Rect detectHand(const Mat &image);
+
+    /**
+     * @brief Detects hand using Haar cascade classifiers
+     *
+     * Detection runs on a downsampled grayscale copy of the search window and the
+     * rectangle is mapped back to full resolution; feature tracking keeps using the
+     * full resolution frame inside the detected region.
+     * The independent cascade passes run concurrently when parallelCascades is set.
+     * Every detection of the selected pass is appended to the candidates of the frame.
+     *
+     * @param image Input image to process
+     * @param window Region of the image to search
+     * @return Rectangle containing detected hand (empty if no detection)
+     */
+    Rect haarCascade(const Mat &image, const Rect &window);
+
+    /**
+     * @brief Moves the hand position with optical flow instead of running the cascades
+     * @return true if the frame was handled by the flow tracker
+     */
+    bool trackWithOpticalFlow();
+
+    /**
+     * @brief Detects and tracks the first hand on the current frame
+     */
+    void trackFirstHand();
+
+    /**
+     * @brief Updates the second hand from the detections of the frame, or with optical flow in between
+     */
+    void trackSecondHand();
+
+    /**
+     * @brief Computes the part of a detection kept as a reference image
+     * @param detection Detected hand region
+     * @param frameSize Size of the frame
+     * @return Central part of the hand, clipped to the frame (empty if too small)
+     */
+    Rect referenceRect(const Rect &detection, const Size &frameSize) const;
+
+    /**
+     * @brief Captures reference image when hand is consistently detected
+     */
+    void captureReference();
+
+    /**
+     * @brief Rotates an image by a given angle
+     * @param src Source image
+     * @param angle Rotation angle in degrees
+     * @return Rotated image
+     */
+    Mat rotateImage(const Mat &src, float angle);
+};
+
+#endif // VISIONPIPELINE_H
@@ -0,0 +1,42 @@
+#include "visionProfiler.h"
+
+QString VisionProfiler::stageName(Stage stage)
+{
+    switch (stage)
+    {
+    case Capture:
+        return "capture";
+    case Flip:
+        return "flip";
+    case Grayscale:
+        return "gray/equalize";
+    case CascadeFist:
+        return "cascade fist";
+    case CascadeInvertedPalm:
+        return "cascade inv. palm";
+    case CascadePalm:
+        return "cascade palm";
+    case SkinDetection:
+        return "skin";
+    case OpticalFlow:
+        return "optical flow";
+    case FeatureDetect:
+        return "feature detect";
+    case FeatureMatch:
+        return "feature match";
+    case Preview:
+        return "preview";
+    case Total:
+        return "total";
+    default:
+        return QString();
+    }
+}
+
+void VisionProfiler::clear()
+{
+    for (LatencyHistogram &histogram : m_histograms)
+    {
+        histogram.clear();
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef VISIONPROFILER_H
+#define VISIONPROFILER_H
+
+#include <QString>
+#include "latencyHistogram.h"
+
+/**
+ * @brief Rolling latency histograms of the vision pipeline stages
+ *
+ * Owned by the pipeline and only used from the vision thread. Stages that do not
+ * run on a frame (e.g. the palm cascade once a fist is found) simply record nothing.
+ */
+class VisionProfiler
+{
+public:
+    /**
+     * @brief Timed stages of the pipeline
+     */
+    enum Stage
+    {
+        Capture = 0,         // Reading the frame from the source
+        Flip,                // Mirroring the frame
+        Grayscale,           // Grayscale conversion, downsampling and equalization for detection
+        CascadeFist,         // Fist cascade pass
+        CascadeInvertedPalm, // Palm cascade pass on the inverted image
+        CascadePalm,         // Palm cascade pass on the gray image
+        SkinDetection,       // Skin colour segmentation
+        OpticalFlow,         // Lucas-Kanade flow update
+        FeatureDetect,       // Keypoint detection and description in the hand region
+        FeatureMatch,        // Matching against the reference descriptors
+        Preview,             // Annotated frame and preview image conversion
+        Total,               // Whole frame, from capture to preview
+        StageCount
+    };
+
+    /**
+     * @brief Get the display name of a stage
+     * @param stage Stage
+     * @return Short name such as "capture" or "cascade fist"
+     */
+    static QString stageName(Stage stage);
+
+    /**
+     * @brief Records the duration of a stage
+     * @param stage Stage
+     * @param ms Duration in milliseconds
+     */
+    void record(Stage stage, double ms) { m_histograms[stage].add(ms); }
+
+    /**
+     * @brief Get the histogram of a stage
+     * @param stage Stage
+     * @return Rolling histogram of the last durations
+     */
+    const LatencyHistogram &histogram(Stage stage) const { return m_histograms[stage]; }
+
+    /**
+     * @brief Removes all the recorded durations
+     */
+    void clear();
+
+private:
+    LatencyHistogram m_histograms[StageCount]; // One histogram per stage
+};
+
+#endif // VISIONPROFILER_H
@@ -0,0 +1,61 @@
+#ifndef VISIONSETTINGS_H
+#define VISIONSETTINGS_H
+
+#include "handTracker.h"
+
+/**
+ * @brief Runtime configuration of the vision pipeline
+ *
+ * Set from the GUI thread through VisionWorker::setSettings() and applied by the
+ * vision thread before the next frame is processed.
+ */
+struct VisionSettings
+{
+    /**
+     * @brief Detector used to find the hand before and between tracking
+     */
+    enum DetectorBackend
+    {
+        HaarCascadeDetector = 0, // Fist and palm Haar cascades
+        SkinColorDetector,       // Largest skin coloured blob (YCrCb threshold)
+        DetectorBackendCount
+    };
+
+    DetectorBackend detectorBackend = HaarCascadeDetector; // Detector used to find the hand
+    HandTracker::Backend trackerBackend = HandTracker::Sift; // Feature tracker used once the reference is captured
+    float matchRatio = 0.0f; // Lowe ratio test threshold of the feature tracker, 0 = default of the backend
+
+    // Reference capture
+    int requiredDetections = 5; // Consecutive close detections required to capture the reference image
+    int referenceKeyframes = 4; // Keyframes kept for other poses and lighting, 1 = single reference re-acquired after a loss
+
+    // Haar search window around the last detection
+    bool searchWindowEnabled = true; // Search around the last detection before scanning the whole frame
+    double searchWindowScale = 2.0;  // Size of the first window relative to the last detected hand
+    double searchWindowGrowth = 1.5; // Growth factor of the window after each consecutive miss
+
+    // Cascade detection resolution
+    int detectionScale = 0; // Downsampling factor for cascade detection (1, 2 or 4), 0 = automatic
+
+    // Cascade passes scheduling
+    bool parallelCascades = true;  // Run the independent cascade passes concurrently on a small thread pool
+    bool palmEarlyCancel = true;   // Only run the palm pass once the fist passes found nothing
+
+    // Optical flow tracking between cascade detections
+    bool opticalFlowEnabled = true; // Follow the hand with Lucas-Kanade flow between detections
+    double flowMinConfidence = 0.5; // Share of tracked points below which a full detection runs
+    int redetectInterval = 10;      // Flow frames between two full detections (initial value when adaptive)
+
+    // Detection cadence while tracking (DetectionScheduler)
+    bool adaptiveRedetect = true;   // Adapt the flow frames between detections to the match quality and the frame budget
+    int maxRedetectInterval = 30;   // Largest number of flow frames between two full detections when adaptive
+    int redetectQuality = 10;       // Match quality below which the next frame runs a full detection again
+    double frameBudgetMs = 0.0;     // Average processing time allowed per frame, 0 = frame interval of the source
+
+    // Two-sword mode
+    int maxHands = 1; // Hands tracked at the same time, 1 or MAX_HANDS
+
+    static const int MAX_HANDS = 2; // Largest number of hands the pipeline can track
+};
+
+#endif // VISIONSETTINGS_H
@@ -0,0 +1,62 @@
+#ifndef VISIONSTATS_H
+#define VISIONSTATS_H
+
+#include <QtGlobal>
+#include "visionProfiler.h"
+
+/**
+ * @brief Counters of the vision pipeline, published by the vision worker
+ *
+ * A snapshot is published after every frame and can be read from the GUI thread
+ * with CameraHandler::visionStats().
+ */
+struct VisionStats
+{
+    // Haar search window around the last detection
+    quint64 windowSearches = 0;    // Cascade searches restricted to a window around the last detection
+    quint64 windowHits = 0;        // Window searches that found a hand
+    quint64 fullFrameSearches = 0; // Cascade searches over the whole frame
+    quint64 fullFrameHits = 0;     // Full frame searches that found a hand
+    int searchWindowLevel = 0;     // Current growth step of the search window (0 = smallest)
+
+    // Detection cadence
+    quint64 detectionFrames = 0;   // Frames where the full detection ran
+    quint64 trackedFrames = 0;     // Frames followed by optical flow only
+    int redetectInterval = 0;      // Flow frames currently allowed between two detections
+
+    // Camera capture, filled by the vision worker from the frame source
+    quint64 processedFrames = 0;   // Frames read and processed since the source was opened
+    quint64 droppedFrames = 0;     // Stale frames skipped to process fresher ones
+    quint64 lateFrames = 0;        // Reads that found the processing behind the camera
+
+    // Rolling latency percentiles of each stage, indexed by VisionProfiler::Stage
+    LatencySummary stageLatency[VisionProfiler::StageCount];
+
+    /**
+     * @brief Get the share of window searches that found the hand
+     * @return Hit rate between 0 and 1
+     */
+    double windowHitRate() const { return windowSearches > 0 ? double(windowHits) / windowSearches : 0.0; }
+
+    /**
+     * @brief Get the share of all searches that were restricted to a window
+     * @return Window ratio between 0 and 1
+     */
+    double windowRatio() const
+    {
+        quint64 total = windowSearches + fullFrameSearches;
+        return total > 0 ? double(windowSearches) / total : 0.0;
+    }
+
+    /**
+     * @brief Get the share of processed frames that ran the full detection
+     * @return Detection ratio between 0 and 1, the rest of the frames were only tracked
+     */
+    double detectionRatio() const
+    {
+        quint64 total = detectionFrames + trackedFrames;
+        return total > 0 ? double(detectionFrames) / total : 0.0;
+    }
+};
+
+#endif // VISIONSTATS_H
@@ -0,0 +1,269 @@
+#include "visionWorker.h"
+#include <QElapsedTimer>
+#include "latencyProbe.h"
+
+VisionWorker::VisionWorker(QObject *parent)
+    : QThread(parent),
+      m_source(nullptr),
+      m_frameRate(0.0),
+      m_sequence(0),
+      m_processedFrames(0),
+      m_settingsChanged(false),
+      m_previewWidth(0),
+      m_previewHeight(0),
+      m_imagePreviewEnabled(true),
+      m_framePreviewEnabled(false),
+      m_previewIndex(0)
+{
+}
+
+VisionWorker::~VisionWorker()
+{
+    stop();
+    delete m_source;
+}
+
+bool VisionWorker::openCamera(int cameraIndex)
+{
+    return openSource(new CameraFrameSource(cameraIndex));
+}
+
+bool VisionWorker::openSource(FrameSource *source)
+{
+    delete m_source;
+    m_source = source;
+
+    if (!m_source || !m_source->isOpened())
+    {
+        delete m_source;
+        m_source = nullptr;
+        m_frameSize = QSize();
+        m_frameRate = 0.0;
+        return false;
+    }
+
+    m_frameSize = m_source->frameSize();
+    m_frameRate = m_source->frameRate();
+    m_processedFrames = 0;
+
+    // Reset detection states for the new source
+    m_pipeline.reset(m_source, m_frameSize.width(), m_frameSize.height());
+    m_summaryTimer.invalidate();
+    return true;
+}
+
+bool VisionWorker::releaseSource()
+{
+    if (!m_source || !m_source->isOpened())
+    {
+        return false;
+    }
+
+    m_source->release();
+    m_frameSize = QSize();
+    m_frameRate = 0.0;
+    return true;
+}
+
+void VisionWorker::stop()
+{
+    if (isRunning())
+    {
+        requestInterruption();
+        wait();
+    }
+}
+
+void VisionWorker::setPreviewSize(const QSize &size)
+{
+    m_previewWidth.store(size.width(), std::memory_order_relaxed);
+    m_previewHeight.store(size.height(), std::memory_order_relaxed);
+}
+
+void VisionWorker::setSettings(const VisionSettings &settings)
+{
+    QMutexLocker locker(&m_settingsMutex);
+    m_pendingSettings = settings;
+    m_settingsChanged.store(true, std::memory_order_release);
+}
+
+void VisionWorker::run()
+{
+    QElapsedTimer frameTimer;
+    Mat frame;
+
+    while (!isInterruptionRequested())
+    {
+        frameTimer.start();
+
+        // Apply configuration changes between two frames
+        if (m_settingsChanged.exchange(false, std::memory_order_acquire))
+        {
+            QMutexLocker locker(&m_settingsMutex);
+            m_pipeline.applySettings(m_pendingSettings);
+        }
+
+        QElapsedTimer stageTimer;
+        stageTimer.start();
+        if (!m_source || !m_source->isOpened() || !m_source->read(frame))
+        {
+            // A finished recording stops the thread, a camera may deliver again later
+            if (m_source && m_source->atEnd())
+            {
+                emit sourceFinished();
+                break;
+            }
+            msleep(FRAME_INTERVAL_MS);
+            continue;
+        }
+        // The source tags the frame with the time it was taken from the device, before the decoding
+        qint64 captureTimeNs = m_source->captureTimeNs();
+        m_processedFrames++;
+        VisionProfiler &profiler = m_pipeline.profiler();
+        profiler.record(VisionProfiler::Capture, stageTimer.nsecsElapsed() / 1.0e6);
+
+        m_pipeline.processFrame(frame);
+
+        // Publish the tracked position for the game loop
+        QPoint position = m_pipeline.trackedHandPosition();
+        HandSample sample;
+        sample.x = position.x();
+        sample.y = position.y();
+        sample.frameWidth = frame.cols;
+        sample.frameHeight = frame.rows;
+        sample.matchQuality = m_pipeline.getMatchQuality();
+        sample.confidence = static_cast<float>(m_pipeline.trackingConfidence());
+        sample.valid = m_pipeline.trackingConfidence() > 0.0; // Position updated on this frame
+        sample.sequence = ++m_sequence;
+        sample.timestampNs = captureTimeNs;
+        LatencyProbe::instance().mark(LatencyProbe::Capture, sample.sequence, captureTimeNs);
+        LatencyProbe::instance().mark(LatencyProbe::Published, sample.sequence);
+        m_sampleMailbox[0].publish(sample);
+        RecordedFrame recorded;
+        recorded.hands[0] = sample;
+
+        // The second hand shares the frame, only its position and confidence differ
+        const HandTrack &secondHand = m_pipeline.secondHand();
+        sample.x = secondHand.position.x;
+        sample.y = secondHand.position.y;
+        sample.matchQuality = 0;
+        sample.confidence = static_cast<float>(secondHand.confidence);
+        sample.valid = secondHand.tracked;
+        sample.hand = 1;
+        m_sampleMailbox[1].publish(sample);
+
+        // Recording only costs a copy of the raw frame into the writer queue
+        if (m_recorder.isRecording())
+        {
+            recorded.hands[1] = sample;
+            recorded.handRect = m_pipeline.handRect();
+            recorded.tracking = m_pipeline.isTracking();
+            m_recorder.push(frame, recorded);
+        }
+
+        // Annotated full resolution frame for the GL preview, written in place into the mailbox.
+        // The copy is skipped when no texture preview reads the frames.
+        stageTimer.restart();
+        if (m_framePreviewEnabled.load(std::memory_order_relaxed))
+        {
+            Mat &annotated = m_frameMailbox.backBuffer();
+            m_pipeline.frame().copyTo(annotated);
+            m_pipeline.overlay().draw(annotated);
+            m_frameMailbox.publishBackBuffer();
+        }
+
+        QImage img;
+        if (m_imagePreviewEnabled.load(std::memory_order_relaxed))
+        {
+            // Build the preview here so that the GUI thread only has to display it.
+            // The frame is scaled into a pooled buffer, annotated at preview resolution,
+            // and the RGB conversion writes straight into a recycled image owned by Qt.
+            const Mat &processed = m_pipeline.frame();
+            QSize previewSize(processed.cols, processed.rows);
+            int previewWidth = m_previewWidth.load(std::memory_order_relaxed);
+            int previewHeight = m_previewHeight.load(std::memory_order_relaxed);
+            if (previewWidth > 0 && previewHeight > 0)
+            {
+                // Scale image while preserving aspect ratio
+                previewSize.scale(previewWidth, previewHeight, Qt::KeepAspectRatio);
+            }
+            if (previewSize.isEmpty())
+            {
+                previewSize = QSize(processed.cols, processed.rows);
+            }
+
+            if (previewSize == QSize(processed.cols, processed.rows))
+            {
+                processed.copyTo(m_previewBgr);
+            }
+            else
+            {
+                cv::resize(processed, m_previewBgr, Size(previewSize.width(), previewSize.height()), 0, 0, INTER_AREA);
+            }
+            m_pipeline.overlay().draw(m_previewBgr, double(previewSize.width()) / processed.cols);
+
+            QImage &pooled = nextPreviewImage(previewSize);
+            Mat rgbView(pooled.height(), pooled.width(), CV_8UC3, pooled.bits(), pooled.bytesPerLine());
+            cvtColor(m_previewBgr, rgbView, COLOR_BGR2RGB);
+            img = pooled;
+        }
+        profiler.record(VisionProfiler::Preview, stageTimer.nsecsElapsed() / 1.0e6);
+        profiler.record(VisionProfiler::Total, frameTimer.nsecsElapsed() / 1.0e6);
+
+        // The latency percentiles sort the histograms, they are only refreshed a few times per second
+        if (!m_summaryTimer.isValid() || m_summaryTimer.elapsed() >= SUMMARY_PERIOD_MS)
+        {
+            m_summaryTimer.start();
+            for (int stage = 0; stage < VisionProfiler::StageCount; stage++)
+            {
+                m_stageLatency[stage] = profiler.histogram(static_cast<VisionProfiler::Stage>(stage)).summary();
+            }
+        }
+
+        // Publish the counters with the latest latency percentiles
+        VisionStats &stats = m_statsMailbox.backBuffer();
+        stats = m_pipeline.stats();
+        stats.processedFrames = m_processedFrames;
+        stats.droppedFrames = m_source->droppedFrames();
+        stats.lateFrames = m_source->lateFrames();
+        for (int stage = 0; stage < VisionProfiler::StageCount; stage++)
+        {
+            stats.stageLatency[stage] = m_stageLatency[stage];
+        }
+        m_statsMailbox.publishBackBuffer();
+
+        emit frameProcessed(img, m_pipeline.statusText());
+
+        // Keep the original ~30 ms cadence for cameras, recorded sources pace themselves
+        if (!m_source->isLive())
+        {
+            continue;
+        }
+        qint64 remaining = FRAME_INTERVAL_MS - frameTimer.elapsed();
+        if (remaining > 0)
+        {
+            msleep(static_cast<unsigned long>(remaining));
+        }
+    }
+}
+
+QImage &VisionWorker::nextPreviewImage(const QSize &size)
+{
+    // Reuse an image the GUI thread no longer references, so writing to it does not detach
+    for (int i = 0; i < PREVIEW_BUFFERS; i++)
+    {
+        int index = (m_previewIndex + i) % PREVIEW_BUFFERS;
+        QImage &img = m_previewImages[index];
+        if (img.size() == size && img.isDetached())
+        {
+            m_previewIndex = (index + 1) % PREVIEW_BUFFERS;
+            return img;
+        }
+    }
+
+    // All images are still displayed or the preview was resized: replace the oldest one
+    QImage &img = m_previewImages[m_previewIndex];
+    img = QImage(size, QImage::Format_RGB888);
+    m_previewIndex = (m_previewIndex + 1) % PREVIEW_BUFFERS;
+    return img;
+}
@@ -0,0 +1,195 @@
+#ifndef VISIONWORKER_H
+#define VISIONWORKER_H
+
+#include "opencv2/opencv.hpp"
+#include <QThread>
+#include <QImage>
+#include <QSize>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <atomic>
+#include "frameSource.h"
+#include "visionPipeline.h"
+#include "handSample.h"
+#include "latestValueMailbox.h"
+#include "sessionRecorder.h"
+#include "visionSettings.h"
+#include "visionStats.h"
+
+using namespace cv;
+
+/**
+ * @brief The VisionWorker class runs frame capture and hand detection on its own thread
+ *
+ * The worker owns the FrameSource and the VisionPipeline. Each processed frame
+ * publishes a HandSample and the annotated frame into lock-free mailboxes that the
+ * GUI thread reads without blocking, and optionally emits a scaled preview image.
+ *
+ * openCamera(), openSource() and releaseSource() must only be called while the thread is stopped.
+ */
+class VisionWorker : public QThread
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param parent Parent QObject
+     */
+    explicit VisionWorker(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor stops the thread and releases the frame source
+     */
+    ~VisionWorker();
+
+    /**
+     * @brief Opens the camera with the specified index and resets the pipeline
+     * @param cameraIndex Index of the camera to open (0 = internal, 1 = external)
+     * @return true if successful, false otherwise
+     */
+    bool openCamera(int cameraIndex);
+
+    /**
+     * @brief Replaces the frame source and resets the pipeline
+     * @param source Opened source, ownership is taken even on failure
+     * @return true if the source is opened, false otherwise
+     */
+    bool openSource(FrameSource *source);
+
+    /**
+     * @brief Releases the current frame source
+     * @return true if a source was released, false otherwise
+     */
+    bool releaseSource();
+
+    /**
+     * @brief Get the size of the frames delivered by the source
+     * @return Frame size in pixels (empty if no source is opened)
+     */
+    QSize frameSize() const { return m_frameSize; }
+
+    /**
+     * @brief Get the frame rate of the source
+     * @return Frames per second announced by the opened source (0 if none)
+     */
+    double frameRate() const { return m_frameRate; }
+
+    /**
+     * @brief Get the recorder fed with every processed frame while it records
+     * @return Session recorder, started and stopped from the GUI thread
+     */
+    SessionRecorder &recorder() { return m_recorder; }
+
+    /**
+     * @brief Requests the thread to stop and waits until it has finished
+     */
+    void stop();
+
+    /**
+     * @brief Reads the latest hand sample without blocking (GUI thread only)
+     * @param sample Receives the latest published sample
+     * @param hand Index of the hand, below VisionSettings::MAX_HANDS
+     * @return true if the sample is new since the previous call
+     */
+    bool readLatestSample(HandSample &sample, int hand = 0) { return m_sampleMailbox[hand].read(sample); }
+
+    /**
+     * @brief Reads the latest pipeline counters without blocking (GUI thread only)
+     * @param stats Receives the latest published counters
+     * @return true if the counters are new since the previous call
+     */
+    bool readLatestStats(VisionStats &stats) { return m_statsMailbox.read(stats); }
+
+    /**
+     * @brief Get the latest annotated frame without copying it (GUI thread only)
+     * @return Mirrored BGR frame if a new one was published since the previous call, nullptr otherwise
+     *
+     * The frame stays valid until the next call. Frames are only published while setFramePreviewEnabled() is on.
+     */
+    const Mat *acquireLatestFrame() { return m_frameMailbox.acquire() ? &m_frameMailbox.front() : nullptr; }
+
+    /**
+     * @brief Enables or disables the scaled QImage preview sent with frameProcessed()
+     * @param enabled false when the frames are displayed from acquireLatestFrame() instead
+     */
+    void setImagePreviewEnabled(bool enabled) { m_imagePreviewEnabled.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief Enables or disables the full resolution frames published for acquireLatestFrame()
+     * @param enabled true when a texture preview consumes the frames, off by default to save a frame copy
+     */
+    void setFramePreviewEnabled(bool enabled) { m_framePreviewEnabled.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief Sets the size the preview image should be scaled to
+     * @param size Target size of the preview, aspect ratio is preserved
+     */
+    void setPreviewSize(const QSize &size);
+
+    /**
+     * @brief Sets the pipeline configuration, applied before the next frame
+     * @param settings New settings
+     */
+    void setSettings(const VisionSettings &settings);
+
+signals:
+    /**
+     * @brief Emitted after each processed frame
+     * @param preview Annotated preview image, already scaled for display (null if the image preview is disabled)
+     * @param status Status text describing the detection state
+     */
+    void frameProcessed(const QImage &preview, const QString &status);
+
+    /**
+     * @brief Emitted from the worker thread when a recorded source has delivered all its frames
+     */
+    void sourceFinished();
+
+protected:
+    /**
+     * @brief Capture loop: reads, processes and publishes frames until interrupted or the end of a recording
+     */
+    void run() override;
+
+private:
+    FrameSource *m_source; // Source of the frames, only used by the worker thread while running (nullptr if none)
+    VisionPipeline m_pipeline; // Detection and tracking pipeline
+    LatestValueMailbox<HandSample> m_sampleMailbox[VisionSettings::MAX_HANDS]; // Latest sample of each hand for the GUI thread
+    LatestValueMailbox<VisionStats> m_statsMailbox; // Latest pipeline counters for the GUI thread
+    LatestValueMailbox<Mat> m_frameMailbox; // Latest annotated frame, filled in place to reuse its buffers
+    QSize m_frameSize; // Size of the frames of the opened source
+    double m_frameRate; // Frame rate of the opened source
+    SessionRecorder m_recorder; // Writes the raw frames and tracker outputs to disk while recording
+    quint64 m_sequence; // Index of the last processed frame
+    quint64 m_processedFrames; // Frames processed since the source was opened
+
+    QMutex m_settingsMutex; // Protects m_pendingSettings
+    VisionSettings m_pendingSettings; // Settings waiting to be applied by the worker thread
+    std::atomic<bool> m_settingsChanged; // Flag indicating if m_pendingSettings must be applied
+
+    std::atomic<int> m_previewWidth; // Preview target width set by the GUI thread
+    std::atomic<int> m_previewHeight; // Preview target height set by the GUI thread
+    std::atomic<bool> m_imagePreviewEnabled; // Flag indicating if the scaled QImage preview is built
+    std::atomic<bool> m_framePreviewEnabled; // Flag indicating if the annotated frame is published to m_frameMailbox
+
+    static const int PREVIEW_BUFFERS = 3; // Preview images in flight between the worker and the GUI thread
+    Mat m_previewBgr; // Scaled and annotated preview before the RGB conversion (pooled)
+    QImage m_previewImages[PREVIEW_BUFFERS]; // Recycled preview images
+    int m_previewIndex; // Index of the next preview image to try
+
+    LatencySummary m_stageLatency[VisionProfiler::StageCount]; // Latency percentiles published with the counters
+    QElapsedTimer m_summaryTimer; // Time since the percentiles were computed (invalid to refresh them on the next frame)
+
+    /**
+     * @brief Get a preview image that can be written without allocating
+     * @param size Size of the preview
+     * @return Image not referenced by the GUI thread anymore, or a new one if there is none
+     */
+    QImage &nextPreviewImage(const QSize &size);
+
+    static const int FRAME_INTERVAL_MS = 30; // Minimum interval between two processed camera frames
+    static const int SUMMARY_PERIOD_MS = 500; // Interval between two computations of the latency percentiles
+};
+
+#endif // VISIONWORKER_H